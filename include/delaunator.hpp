@@ -98,18 +98,19 @@ inline std::pair<double, double> circumcenter(
     return std::make_pair(x, y);
 }
 
+template <typename Index, typename Coords>
 struct compare {
 
-    std::vector<double> const& coords;
+    Coords const& coords;
     double cx;
     double cy;
 
-    bool operator()(std::size_t i, std::size_t j) {
+    bool operator()(Index i, Index j) {
         const double d1 = dist(coords[2 * i], coords[2 * i + 1], cx, cy);
         const double d2 = dist(coords[2 * j], coords[2 * j + 1], cx, cy);
         const double diff1 = d1 - d2;
-        const double diff2 = coords[2 * i] - coords[2 * j];
-        const double diff3 = coords[2 * i + 1] - coords[2 * j + 1];
+        const double diff2 = double(coords[2 * i]) - double(coords[2 * j]);
+        const double diff3 = double(coords[2 * i + 1]) - double(coords[2 * j + 1]);
 
         if (diff1 > 0.0 || diff1 < 0.0) {
             return diff1 < 0;
@@ -170,41 +171,51 @@ struct DelaunatorPoint {
     bool removed;
 };
 
+// Index: type of the point, triangle and halfedge indices (std::uint32_t halves the index memory, up to about 715 million points).
+// Coord: type of the input coordinates, read as double by every predicate, so float coordinates
+// rebased to a local origin triangulate as robustly as the original ones.
+// Allocator, CoordAllocator: allocators of the index arrays and of the input coordinates, so a caller can account for them.
+template <typename Index = std::size_t, typename Coord = double,
+          typename Allocator = std::allocator<Index>, typename CoordAllocator = std::allocator<Coord>>
 class Delaunator {
 
 public:
-    std::vector<double> const& coords;
-    std::vector<std::size_t> triangles;
-    std::vector<std::size_t> halfedges;
-    std::vector<std::size_t> hull_prev;
-    std::vector<std::size_t> hull_next;
-    std::vector<std::size_t> hull_tri;
-    std::size_t hull_start;
+    static constexpr Index INVALID = std::numeric_limits<Index>::max();
 
-    Delaunator(std::vector<double> const& in_coords);
+    std::vector<Coord, CoordAllocator> const& coords;
+    std::vector<Index, Allocator> triangles;
+    std::vector<Index, Allocator> halfedges;
+    std::vector<Index, Allocator> hull_prev;
+    std::vector<Index, Allocator> hull_next;
+    std::vector<Index, Allocator> hull_tri;
+    Index hull_start;
+
+    // max_triangles: capacity reserved for triangles and halfedges, 0 for the upper bound 2n - 5
+    Delaunator(std::vector<Coord, CoordAllocator> const& in_coords, std::size_t max_triangles = 0);
 
     double get_hull_area();
 
 private:
-    std::vector<std::size_t> m_hash;
+    std::vector<Index, Allocator> m_hash;
     double m_center_x;
     double m_center_y;
     std::size_t m_hash_size;
-    std::vector<std::size_t> m_edge_stack;
+    std::vector<Index, Allocator> m_edge_stack;
 
-    std::size_t legalize(std::size_t a);
+    Index legalize(Index a);
     std::size_t hash_key(double x, double y) const;
-    std::size_t add_triangle(
-        std::size_t i0,
-        std::size_t i1,
-        std::size_t i2,
-        std::size_t a,
-        std::size_t b,
-        std::size_t c);
-    void link(std::size_t a, std::size_t b);
+    Index add_triangle(
+        Index i0,
+        Index i1,
+        Index i2,
+        Index a,
+        Index b,
+        Index c);
+    void link(Index a, Index b);
 };
 
-Delaunator::Delaunator(std::vector<double> const& in_coords)
+template <typename Index, typename Coord, typename Allocator, typename CoordAllocator>
+Delaunator<Index, Coord, Allocator, CoordAllocator>::Delaunator(std::vector<Coord, CoordAllocator> const& in_coords, std::size_t max_triangles)
     : coords(in_coords),
       triangles(),
       halfedges(),
@@ -218,12 +229,15 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
       m_hash_size(),
       m_edge_stack() {
     std::size_t n = coords.size() >> 1;
+    if (n > (INVALID - 1) / 6) { // halfedge indices go up to 3 * (2n - 5)
+        throw std::runtime_error("too many points for the index type");
+    }
 
-    double max_x = std::numeric_limits<double>::min();
-    double max_y = std::numeric_limits<double>::min();
+    double max_x = std::numeric_limits<double>::lowest();
+    double max_y = std::numeric_limits<double>::lowest();
     double min_x = std::numeric_limits<double>::max();
     double min_y = std::numeric_limits<double>::max();
-    std::vector<std::size_t> ids;
+    std::vector<Index, Allocator> ids;
     ids.reserve(n);
 
     for (std::size_t i = 0; i < n; i++) {
@@ -241,9 +255,9 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
     const double cy = (min_y + max_y) / 2;
     double min_dist = std::numeric_limits<double>::max();
 
-    std::size_t i0 = INVALID_INDEX;
-    std::size_t i1 = INVALID_INDEX;
-    std::size_t i2 = INVALID_INDEX;
+    Index i0 = INVALID;
+    Index i1 = INVALID;
+    Index i2 = INVALID;
 
     // pick a seed point close to the centroid
     for (std::size_t i = 0; i < n; i++) {
@@ -303,12 +317,12 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
     std::tie(m_center_x, m_center_y) = circumcenter(i0x, i0y, i1x, i1y, i2x, i2y);
 
     // sort the points by distance from the seed triangle circumcenter
-    std::sort(ids.begin(), ids.end(), compare{ coords, m_center_x, m_center_y });
+    std::sort(ids.begin(), ids.end(), compare<Index, std::vector<Coord, CoordAllocator>>{ coords, m_center_x, m_center_y });
 
     // initialize a hash table for storing edges of the advancing convex hull
     m_hash_size = static_cast<std::size_t>(std::llround(std::ceil(std::sqrt(n))));
     m_hash.resize(m_hash_size);
-    std::fill(m_hash.begin(), m_hash.end(), INVALID_INDEX);
+    std::fill(m_hash.begin(), m_hash.end(), INVALID);
 
     // initialize arrays for tracking the edges of the advancing convex hull
     hull_prev.resize(n);
@@ -331,14 +345,16 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
     m_hash[hash_key(i1x, i1y)] = i1;
     m_hash[hash_key(i2x, i2y)] = i2;
 
-    std::size_t max_triangles = n < 3 ? 1 : 2 * n - 5;
+    if (max_triangles == 0) {
+        max_triangles = n < 3 ? 1 : 2 * n - 5;
+    }
     triangles.reserve(max_triangles * 3);
     halfedges.reserve(max_triangles * 3);
-    add_triangle(i0, i1, i2, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX);
+    add_triangle(i0, i1, i2, INVALID, INVALID, INVALID);
     double xp = std::numeric_limits<double>::quiet_NaN();
     double yp = std::numeric_limits<double>::quiet_NaN();
     for (std::size_t k = 0; k < n; k++) {
-        const std::size_t i = ids[k];
+        const Index i = ids[k];
         const double x = coords[2 * i];
         const double y = coords[2 * i + 1];
 
@@ -354,35 +370,35 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
             check_pts_equal(x, y, i2x, i2y)) continue;
 
         // find a visible edge on the convex hull using edge hash
-        std::size_t start = 0;
+        Index start = 0;
 
         size_t key = hash_key(x, y);
         for (size_t j = 0; j < m_hash_size; j++) {
             start = m_hash[fast_mod(key + j, m_hash_size)];
-            if (start != INVALID_INDEX && start != hull_next[start]) break;
+            if (start != INVALID && start != hull_next[start]) break;
         }
 
         start = hull_prev[start];
-        size_t e = start;
-        size_t q;
+        Index e = start;
+        Index q;
 
         while (q = hull_next[e], !orient(x, y, coords[2 * e], coords[2 * e + 1], coords[2 * q], coords[2 * q + 1])) { //TODO: does it works in a same way as in JS
             e = q;
             if (e == start) {
-                e = INVALID_INDEX;
+                e = INVALID;
                 break;
             }
         }
 
-        if (e == INVALID_INDEX) continue; // likely a near-duplicate point; skip it
+        if (e == INVALID) continue; // likely a near-duplicate point; skip it
 
         // add the first triangle from the point
-        std::size_t t = add_triangle(
+        Index t = add_triangle(
             e,
             i,
             hull_next[e],
-            INVALID_INDEX,
-            INVALID_INDEX,
+            INVALID,
+            INVALID,
             hull_tri[e]);
 
         hull_tri[i] = legalize(t + 2);
@@ -390,11 +406,11 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
         hull_size++;
 
         // walk forward through the hull, adding more triangles and flipping recursively
-        std::size_t next = hull_next[e];
+        Index next = hull_next[e];
         while (
             q = hull_next[next],
             orient(x, y, coords[2 * next], coords[2 * next + 1], coords[2 * q], coords[2 * q + 1])) {
-            t = add_triangle(next, i, q, hull_tri[i], INVALID_INDEX, hull_tri[next]);
+            t = add_triangle(next, i, q, hull_tri[i], INVALID, hull_tri[next]);
             hull_tri[i] = legalize(t + 2);
             hull_next[next] = next; // mark as removed
             hull_size--;
@@ -406,7 +422,7 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
             while (
                 q = hull_prev[e],
                 orient(x, y, coords[2 * q], coords[2 * q + 1], coords[2 * e], coords[2 * e + 1])) {
-                t = add_triangle(q, i, e, INVALID_INDEX, hull_tri[e], hull_tri[q]);
+                t = add_triangle(q, i, e, INVALID, hull_tri[e], hull_tri[q]);
                 legalize(t + 2);
                 hull_tri[q] = t;
                 hull_next[e] = e; // mark as removed
@@ -427,24 +443,26 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
     }
 }
 
-double Delaunator::get_hull_area() {
+template <typename Index, typename Coord, typename Allocator, typename CoordAllocator>
+double Delaunator<Index, Coord, Allocator, CoordAllocator>::get_hull_area() {
     std::vector<double> hull_area;
-    size_t e = hull_start;
+    Index e = hull_start;
     do {
-        hull_area.push_back((coords[2 * e] - coords[2 * hull_prev[e]]) * (coords[2 * e + 1] + coords[2 * hull_prev[e] + 1]));
+        hull_area.push_back((double(coords[2 * e]) - coords[2 * hull_prev[e]]) * (double(coords[2 * e + 1]) + coords[2 * hull_prev[e] + 1]));
         e = hull_next[e];
     } while (e != hull_start);
     return sum(hull_area);
 }
 
-std::size_t Delaunator::legalize(std::size_t a) {
+template <typename Index, typename Coord, typename Allocator, typename CoordAllocator>
+Index Delaunator<Index, Coord, Allocator, CoordAllocator>::legalize(Index a) {
     std::size_t i = 0;
-    std::size_t ar = 0;
+    Index ar = 0;
     m_edge_stack.clear();
 
     // recursion eliminated with a fixed-size stack
     while (true) {
-        const size_t b = halfedges[a];
+        const Index b = halfedges[a];
 
         /* if the pair of triangles doesn't satisfy the Delaunay condition
         * (p1 is inside the circumcircle of [p0, pl, pr]), flip them,
@@ -461,10 +479,10 @@ std::size_t Delaunator::legalize(std::size_t a) {
         *          \||/                  \  /
         *           pr                    pr
         */
-        const size_t a0 = 3 * (a / 3);
+        const Index a0 = 3 * (a / 3);
         ar = a0 + (a + 2) % 3;
 
-        if (b == INVALID_INDEX) {
+        if (b == INVALID) {
             if (i > 0) {
                 i--;
                 a = m_edge_stack[i];
@@ -475,14 +493,14 @@ std::size_t Delaunator::legalize(std::size_t a) {
             }
         }
 
-        const size_t b0 = 3 * (b / 3);
-        const size_t al = a0 + (a + 1) % 3;
-        const size_t bl = b0 + (b + 2) % 3;
+        const Index b0 = 3 * (b / 3);
+        const Index al = a0 + (a + 1) % 3;
+        const Index bl = b0 + (b + 2) % 3;
 
-        const std::size_t p0 = triangles[ar];
-        const std::size_t pr = triangles[a];
-        const std::size_t pl = triangles[al];
-        const std::size_t p1 = triangles[bl];
+        const Index p0 = triangles[ar];
+        const Index pr = triangles[a];
+        const Index pl = triangles[al];
+        const Index p1 = triangles[bl];
 
         const bool illegal = in_circle(
             coords[2 * p0],
@@ -501,8 +519,8 @@ std::size_t Delaunator::legalize(std::size_t a) {
             auto hbl = halfedges[bl];
 
             // edge swapped on the other side of the hull (rare); fix the halfedge reference
-            if (hbl == INVALID_INDEX) {
-                std::size_t e = hull_start;
+            if (hbl == INVALID) {
+                Index e = hull_start;
                 do {
                     if (hull_tri[e] == bl) {
                         hull_tri[e] = a;
@@ -514,7 +532,7 @@ std::size_t Delaunator::legalize(std::size_t a) {
             link(a, hbl);
             link(b, halfedges[ar]);
             link(ar, bl);
-            std::size_t br = b0 + (b + 1) % 3;
+            Index br = b0 + (b + 1) % 3;
 
             if (i < m_edge_stack.size()) {
                 m_edge_stack[i] = br;
@@ -536,7 +554,8 @@ std::size_t Delaunator::legalize(std::size_t a) {
     return ar;
 }
 
-inline std::size_t Delaunator::hash_key(const double x, const double y) const {
+template <typename Index, typename Coord, typename Allocator, typename CoordAllocator>
+inline std::size_t Delaunator<Index, Coord, Allocator, CoordAllocator>::hash_key(const double x, const double y) const {
     const double dx = x - m_center_x;
     const double dy = y - m_center_y;
     return fast_mod(
@@ -544,14 +563,15 @@ inline std::size_t Delaunator::hash_key(const double x, const double y) const {
         m_hash_size);
 }
 
-std::size_t Delaunator::add_triangle(
-    std::size_t i0,
-    std::size_t i1,
-    std::size_t i2,
-    std::size_t a,
-    std::size_t b,
-    std::size_t c) {
-    std::size_t t = triangles.size();
+template <typename Index, typename Coord, typename Allocator, typename CoordAllocator>
+Index Delaunator<Index, Coord, Allocator, CoordAllocator>::add_triangle(
+    Index i0,
+    Index i1,
+    Index i2,
+    Index a,
+    Index b,
+    Index c) {
+    Index t = triangles.size();
     triangles.push_back(i0);
     triangles.push_back(i1);
     triangles.push_back(i2);
@@ -561,7 +581,8 @@ std::size_t Delaunator::add_triangle(
     return t;
 }
 
-void Delaunator::link(const std::size_t a, const std::size_t b) {
+template <typename Index, typename Coord, typename Allocator, typename CoordAllocator>
+void Delaunator<Index, Coord, Allocator, CoordAllocator>::link(const Index a, const Index b) {
     std::size_t s = halfedges.size();
     if (a == s) {
         halfedges.push_back(b);
@@ -570,7 +591,7 @@ void Delaunator::link(const std::size_t a, const std::size_t b) {
     } else {
         throw std::runtime_error("Cannot link edge");
     }
-    if (b != INVALID_INDEX) {
+    if (b != INVALID) {
         std::size_t s2 = halfedges.size();
         if (b == s2) {
             halfedges.push_back(a);
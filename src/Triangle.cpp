@@ -2,6 +2,7 @@
 #include <unistd.h>
 #include <cstdlib>
 #include <math.h>
+#include <algorithm>
 #include <iostream> // bibliothèque d’entrées/sorties
 #include "Triangle.h"
 
@@ -14,16 +15,16 @@ using namespace std;
 * \author NOEL Océan
 */
 
-float sign (double x0, double y0, point *p_2, point *p_3);
-double compute_illumination(std::vector<double> &light_dir, std::vector<double> &face_dir);
+float sign (double x0, double y0, const point &p_2, const point &p_3);
 
-Triangle::Triangle(point* p_1,point* p_2,point* p_3)
+Triangle::Triangle(const point &p_1,const point &p_2,const point &p_3)
 {
 	/**
 	* \brief Constructeur de l'objet Triangle.
 	* \param p1 1er point du triangle.
 	* \param p2 2e point du triangle.
 	* \param p3 3e point du triangle.
+	* Les sommets sont copiés : le nuage de points ne stocke pas de structures point (voir point_cloud).
 	*/
 	p1 = p_1;
 	p2 = p_2;
@@ -31,8 +32,8 @@ Triangle::Triangle(point* p_1,point* p_2,point* p_3)
 
 	//Implémentation de l'équation du plan du triangle
 	//selection de deux cotés pour servir de vecteur directeurs du plan
-	vector<double> v1 = {p3->x-p2->x,p3->y-p2->y,p3->depth-p2->depth}; //p2 --> p3
-	vector<double> v2 = {p3->x-p1->x,p3->y-p1->y,p3->depth-p1->depth}; //p1 --> p3
+	vector<double> v1 = {p3.x-p2.x,p3.y-p2.y,p3.depth-p2.depth}; //p2 --> p3
+	vector<double> v2 = {p3.x-p1.x,p3.y-p1.y,p3.depth-p1.depth}; //p1 --> p3
 
 	//calcul du vecteur normal
 	vn = {v1[1]*v2[2]-v2[1]*v1[2],-v1[0]*v2[2]+v2[0]*v1[2],v1[0]*v2[1]-v2[0]*v1[1]};
@@ -40,20 +41,31 @@ Triangle::Triangle(point* p_1,point* p_2,point* p_3)
 
 void Triangle::compute_illumination(vector<double> &light_dir){
 	/**
-	* \brief Cette fonction calcul l'illumination du triangle par rapport à un vecteur de lumière.
+	* \brief Cette fonction calcul l'illumination du triangle par rapport à un vecteur de lumière (voir face_illumination).
+	* \param light_dir direction de la lumière.
+	*/
+	double normal[3] = {vn[0],vn[1],vn[2]};
+	illumination = face_illumination(light_dir.data(),normal);
+}
+
+double face_illumination(const double light_dir[3], const double normal[3]){
+	/**
+	* \brief Cette fonction calcul l'illumination d'une face par rapport à un vecteur de lumière.
 	* - illumination de 1 : face illuminée au maximum 
 	* - illumination de 0 : face non illuminée
 	* \param light_dir direction de la lumière.
+	* \param normal vecteur normal de la face (vn d'un Triangle).
+	* \return Illumination de la face.
 	*/
 
 	//Normalisation des vecteurs
 	double v1_norm = sqrt(pow(light_dir[0],2)+pow(light_dir[1],2)+pow(light_dir[2],2));
-	double v2_norm = sqrt(pow(vn[0],2)+pow(vn[1],2)+pow(vn[2],2));
-	vector<double> v1 = {light_dir[0]/v1_norm,light_dir[1]/v1_norm,light_dir[2]/v1_norm};
-	vector<double> v2 = {-vn[0]/v2_norm,-vn[1]/v2_norm,-vn[2]/v2_norm};
+	double v2_norm = sqrt(pow(normal[0],2)+pow(normal[1],2)+pow(normal[2],2));
+	double v1[3] = {light_dir[0]/v1_norm,light_dir[1]/v1_norm,light_dir[2]/v1_norm};
+	double v2[3] = {-normal[0]/v2_norm,-normal[1]/v2_norm,-normal[2]/v2_norm};
 	
 	//Calcul de l'illumination
-	illumination = v1[0]*v2[0] + v1[1]*v2[1] + v1[2]*v2[2];//produit scalaire 3D
+	double illumination = v1[0]*v2[0] + v1[1]*v2[1] + v1[2]*v2[2];//produit scalaire 3D
 
 	//gestion et ajustement de l'illumination
 	if (illumination > 0){ //on assombri très peu les faces qui recoivent la lumière de face inclinée
@@ -68,6 +80,7 @@ void Triangle::compute_illumination(vector<double> &light_dir){
 		double range = illu_max-illu_min;
 		illumination = max(illu_min,illu_min+((1-pow(abs(illumination),1.0/2))*range)); //nouvelle illumination
 	}
+	return illumination;
 }
 
 double Triangle::compute_depth(double xp, double yp){
@@ -82,7 +95,7 @@ double Triangle::compute_depth(double xp, double yp){
 	double a = vn[0];
 	double b = vn[1];
 	double c = vn[2];
-	double d = -(a*p1->x+b*p1->y+c*p1->depth);
+	double d = -(a*p1.x+b*p1.y+c*p1.depth);
 	//Plan : ax + by + cz + d = 0
 
 	//calcul de la profondeur estimée du point
@@ -91,6 +104,55 @@ double Triangle::compute_depth(double xp, double yp){
 	return depth_estime;
 }
 
+void Triangle::compute_surface(float &slope, float &aspect, float &rugosity){
+	/**
+	* \brief Calcule les caractéristiques du relief du triangle à partir de son vecteur normal.
+	* \param slope pente en degrés (0 = plat).
+	* \param aspect orientation de la pente (direction vers laquelle elle descend) en degrés dans le sens horaire depuis le nord,
+	* -1 si le triangle est plat.
+	* \param rugosity rapport entre la surface du triangle et celle de sa projection horizontale.
+	*/
+
+	//normale orientée vers le haut (les profondeurs négatives sont des altitudes)
+	double nx = vn[0], ny = vn[1], nz = vn[2];
+	if (nz < 0){
+		nx = -nx;
+		ny = -ny;
+		nz = -nz;
+	}
+	double horizontal = sqrt(nx*nx+ny*ny);
+	slope = atan2(horizontal,nz)*180/M_PI;
+	aspect = (horizontal > 0) ? fmod(atan2(nx,ny)*180/M_PI+360,360) : -1; //la normale penche vers le bas de la pente
+	rugosity = sqrt(nx*nx+ny*ny+nz*nz)/max(nz,1e-12);
+}
+
+void Triangle::interpolate_normal(double xp, double yp, float n[3]){
+	/**
+	* \brief Interpole les normales aux sommets (n1,n2,n3) en un point du triangle avec les coordonnées barycentriques.
+	* La normale obtenue n'est pas normalisée, elle l'est lors du calcul de l'ombrage.
+	* \param xp coordonnée x du point à calculer.
+	* \param yp coordonnée y du point à calculer.
+	* \param n tableau dans lequel stocker la normale {nx,ny,nz}.
+	*/
+
+	//coordonnées barycentriques du point
+	double den = (p2.y-p3.y)*(p1.x-p3.x)+(p3.x-p2.x)*(p1.y-p3.y);
+	if (den == 0){ //triangle dégénéré, on garde la normale du premier sommet
+		n[0] = n1[0];
+		n[1] = n1[1];
+		n[2] = n1[2];
+		return;
+	}
+	double l1 = ((p2.y-p3.y)*(xp-p3.x)+(p3.x-p2.x)*(yp-p3.y))/den;
+	double l2 = ((p3.y-p1.y)*(xp-p3.x)+(p1.x-p3.x)*(yp-p3.y))/den;
+	double l3 = 1-l1-l2;
+
+	//interpolation
+	for(int k = 0; k < 3; k++){
+		n[k] = l1*n1[k]+l2*n2[k]+l3*n3[k];
+	}
+}
+
 bool Triangle::contain(double x, double y){
 	/**
 	* \brief Calcul si le point de coordonées x,y se trouve dans le triangle.
@@ -112,7 +174,7 @@ bool Triangle::contain(double x, double y){
 }
 
 
-float sign (double x0, double y0, point *p_2, point *p_3)
+float sign (double x0, double y0, const point &p_2, const point &p_3)
 {
 	/**
 	* \brief Calcul si le point est à gauche ou à droite du segment (p_2,p_3).
@@ -122,5 +184,5 @@ float sign (double x0, double y0, point *p_2, point *p_3)
 	* \param p_3 2e point du segment.
 	* \return float du résultat, négatif si le point est à gauche du coté (v1,v2), positif sinon.
 	*/
-    return (x0 - p_3->x) * (p_2->y - p_3->y) - (p_2->x - p_3->x) * (y0 - p_3->y);
+    return (x0 - p_3.x) * (p_2.y - p_3.y) - (p_2.x - p_3.x) * (y0 - p_3.y);
 }
@@ -1,3 +1,4 @@
+#include <vector>
 #include "struct_point.h"
 
 #ifndef OBJ_TRIANGLE_H
@@ -17,15 +18,23 @@ class Triangle
 * \brief Classe Triangle qui permet d'attribuer une profondeur aux pixels qui lui appartiennent.
 */
 public:
-	Triangle(point* p1,point* p2,point* p3);
+	Triangle(const point &p1,const point &p2,const point &p3);
 	bool contain(double x, double y);
 	double compute_depth(double x, double y);
 	void compute_illumination(std::vector<double> &light_dir);
-	point* p1;
-	point* p2;
-	point* p3;
+	void interpolate_normal(double x, double y, float n[3]);
+	void compute_surface(float &slope, float &aspect, float &rugosity);
+	point p1;
+	point p2;
+	point p3;
 	double illumination = 1; //illumination du triangle, initialement, il est totalement illuminé
 	std::vector<double> vn = {0,0,0}; //vecteur normal du plan du triangle 
+	float* n1 = nullptr; //normales aux sommets {nx,ny,nz} (ombrage lisse uniquement)
+	float* n2 = nullptr;
+	float* n3 = nullptr;
+	std::size_t index = 0; //indice du triangle dans la triangulation (canal triangle, voir pixel_channels)
 };
 
+double face_illumination(const double light_dir[3], const double normal[3]);
+
 #endif
@@ -0,0 +1,164 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <cstring>
+#include <chrono>
+#include <thread> //threads
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h> //projection du fichier en mémoire
+#include "parallel.h"
+#include "generate_image.h"
+#include "bands.h"
+
+/**
+* \file bands.cpp
+* \brief Fichier d'implémentation du rendu par bandes.
+* L'image est découpée en bandes de band_rows lignes. Chaque bande est rendue avec les seuls triangles qui la touchent
+* (voir select_triangles), comme une fenêtre du mode serveur, puis passée par une file de taille limitée à un thread
+* d'écriture qui la convertit en couleurs directement dans le fichier image projeté en mémoire et lance son écriture
+* sur le disque (msync asynchrone) pendant que la bande suivante est rendue.
+* Seules quelques bandes de pixels existent en même temps, et le temps total tend vers le plus long du calcul et de l'écriture.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct pixel_band
+{
+	/**
+	* \brief Bande de pixels rendue, en attente d'écriture.
+	* \param first_row première ligne de la bande dans l'image.
+	* \param pixels couleurs des pixels de la bande.
+	* \param pixels_illumination illuminations des pixels de la bande.
+	*/
+	int first_row = 0;
+	vector<int> pixels;
+	vector<double> pixels_illumination;
+};
+
+bool use_bands(map<string,double> &context){
+	/**
+	* \brief Indique si l'image est rendue par bandes : band_rows lignes par bande (0 = image entière),
+	* sauf avec les ombres portées qui demandent toute l'image.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \return booléen.
+	*/
+	if (context["band_rows"] <= 0){
+		return false;
+	}
+	if (context["shadows"] == 1){
+		cout << "- Cast shadows need the whole image, band rendering disabled" << endl;
+		return false;
+	}
+	return true;
+}
+
+int render_bands(point_cloud &points, tin &t, map<string,double> &context, pixel_channels *channels, string image_name){
+	/**
+	* \brief Rend la triangulation par bandes et écrit l'image au fur et à mesure.
+	* \param points Points de la triangulation.
+	* \param t Triangulation à rendre.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la taille de l'image et des pixels (width,height,lg_pix,h_pix), de ses limites,
+	* du nombre de lignes par bande (band_rows) et des paramètres du rendu (voir color_triangles et colorize_band).
+	* \param channels Canaux des pixels de toute l'image (voir pixel_channels), remplis bande par bande, ignorés si nullptr.
+	* \param image_name nom de l'image à générer.
+	* \return 1 si l'image a été écrite, 0 sinon.
+	*/
+	auto start = chrono::steady_clock::now();
+	int width = context["width"];
+	int height = context["height"];
+	int band_rows = min(height,max(1,int(context["band_rows"])));
+	int nb_bands = (height+band_rows-1)/band_rows;
+	double max_y = context["max_y"];
+	double h_pix = context["h_pix"];
+
+	//fichier image à sa taille finale, projeté en mémoire
+	string header = image_header(width,height);
+	size_t size = header.size()+3*size_t(width)*height;
+	int fd = open(image_name.c_str(),O_RDWR|O_CREAT|O_TRUNC,0644);
+	if (fd < 0){
+		cout << "Impossible de créer " << image_name << endl;
+		return 0;
+	}
+	if (ftruncate(fd,size) != 0){
+		close(fd);
+		cout << "Impossible de créer " << image_name << endl;
+		return 0;
+	}
+	char *image = (char*) mmap(nullptr,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+	if (image == MAP_FAILED){
+		close(fd);
+		cout << "Impossible de projeter " << image_name << " en mémoire" << endl;
+		return 0;
+	}
+	memcpy(image,header.data(),header.size());
+
+	cout << "- Rendering " << nb_bands << " bands of " << band_rows << " rows..." << endl;
+	triangle_grid grid;
+	build_triangle_grid(points,t,context,grid);
+
+	//écriture : conversion en couleurs dans le fichier et écriture des pages de la bande sans attendre
+	bounded_queue<pixel_band> bands(2);
+	double write_seconds = 0;
+	map<string,double> write_context = context; //copie lue par le thread d'écriture seul
+	thread writer([&](){
+		size_t page = sysconf(_SC_PAGE_SIZE);
+		pixel_band band;
+		while(bands.pop(band)){
+			auto t0 = chrono::steady_clock::now();
+			char *begin = image+header.size()+3*size_t(band.first_row)*width;
+			colorize_band(band.pixels,band.pixels_illumination,write_context,begin); //(Voir generate_image.cpp)
+			char *aligned = image+((begin-image)/page)*page; //msync demande une adresse alignée sur une page
+			msync(aligned,begin+3*band.pixels.size()-aligned,MS_ASYNC);
+			write_seconds += chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+		}
+	});
+
+	//rendu des bandes, chacune comme une fenêtre de l'image
+	double compute_seconds = 0;
+	for(int b = 0; b < nb_bands; b++){
+		auto t0 = chrono::steady_clock::now();
+		pixel_band band;
+		band.first_row = b*band_rows;
+		int rows = min(band_rows,height-band.first_row);
+		map<string,double> band_context = context;
+		band_context["max_y"] = max_y-band.first_row*h_pix;
+		band_context["min_y"] = max_y-(band.first_row+rows)*h_pix;
+		band_context["height"] = rows;
+		band.pixels.assign(size_t(width)*rows,context["default_color"]);
+		band.pixels_illumination.assign(size_t(width)*rows,1);
+
+		pixel_channels band_channels;
+		if (channels != nullptr){ //canaux de l'image décalés à la première ligne de la bande
+			size_t offset = size_t(band.first_row)*width;
+			band_channels.depth = channels->depth ? channels->depth+offset : nullptr;
+			band_channels.slope = channels->slope ? channels->slope+offset : nullptr;
+			band_channels.aspect = channels->aspect ? channels->aspect+offset : nullptr;
+			band_channels.rugosity = channels->rugosity ? channels->rugosity+offset : nullptr;
+		}
+
+		vector<size_t> selection;
+		select_triangles(grid,t,band_context["min_x"],band_context["max_x"],band_context["min_y"],band_context["max_y"],selection);
+		color_triangles(points,t,band.pixels,band.pixels_illumination,band_context,&selection,nullptr,&band_channels); //(Voir triangulation.cpp)
+		compute_seconds += chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+		bands.push(move(band));
+	}
+	bands.close();
+	writer.join();
+
+	int result = msync(image,size,MS_SYNC) == 0;
+	munmap(image,size);
+	close(fd);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	cout << "- Bands rendered in " << compute_seconds << " s and written in " << write_seconds << " s, total " << seconds << " s" << endl;
+	if (!result){
+		cout << "Erreur d'écriture de " << image_name << endl;
+	}
+	return result;
+}
@@ -0,0 +1,22 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+#include "dem.h"
+
+#ifndef BANDS_H
+#define BANDS_H
+
+/**
+* \file bands.h
+* \brief Fichier de déclaration du rendu par bandes horizontales, écrites dans l'image par un thread pendant le calcul des suivantes.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+bool use_bands(std::map<std::string,double> &context);
+int render_bands(point_cloud &points, tin &t, std::map<std::string,double> &context, pixel_channels *channels = nullptr, std::string image_name = "raster.ppm");
+
+#endif
@@ -0,0 +1,225 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <sstream>
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+#include "struct_point.h"
+#include "init_points_pixels.h"
+#include "triangulation.h"
+#include "generate_image.h"
+#include "parallel.h"
+#include "text_reader.h"
+#include "batch.h"
+#include "thinning.h"
+#include "binning.h"
+
+/**
+* \file batch.cpp
+* \brief Fichier d'implémentation du mode batch : plusieurs relevés sont traités par un pipeline à trois étapes
+* (lecture et projection, triangulation et coloration, écriture de l'image) qui se recouvrent.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct batch_job
+{
+	/**
+	* \brief Travail du mode batch et données qui passent d'une étape à l'autre.
+	* \param number numéro du travail dans le manifeste.
+	* \param input fichier de relevés.
+	* \param output image à générer.
+	* \param context paramètres du travail (largeur, limites du nuage de points...).
+	* \param points_bytes,pixels_bytes estimations de la mémoire des points (libérée après la coloration) et des pixels.
+	* \param ok faux si une étape a échoué.
+	*/
+	int number = 0;
+	string input;
+	string output;
+	map<string,double> context;
+	point_cloud points;
+	vector<int> pixels;
+	vector<double> pixels_illumination;
+	size_t points_bytes = 0;
+	size_t pixels_bytes = 0;
+	bool ok = true;
+};
+
+class memory_budget
+{
+/**
+* \class memory_budget
+* \brief Mémoire réservée par les travaux en cours : un travail n'entre dans le pipeline que si sa mémoire estimée
+* tient dans le budget (ou si aucun autre travail n'est en cours, pour ne jamais bloquer).
+*/
+public:
+	memory_budget(size_t limit) : limit(limit) {}
+
+	void acquire(size_t bytes){
+		unique_lock<mutex> lock(m);
+		released.wait(lock,[&]{ return used == 0 || used+bytes <= limit; });
+		used += bytes;
+	}
+
+	void release(size_t bytes){
+		lock_guard<mutex> lock(m);
+		used -= min(used,bytes);
+		released.notify_all();
+	}
+
+private:
+	size_t limit;
+	size_t used = 0;
+	mutex m;
+	condition_variable released;
+};
+
+static int read_manifest(string manifest_name, vector<unique_ptr<batch_job>> &jobs, map<string,double> &context);
+
+int run_batch(string manifest_name, map<string,double> &context){
+	/**
+	* \brief Traite tous les travaux d'un manifeste. Chaque étape a son thread et les étapes sont reliées par des files,
+	* ainsi la lecture du travail N+1, la triangulation du travail N et l'écriture de l'image du travail N-1 se recouvrent.
+	* Le manifeste contient une ligne "fichier_releves largeur image_generee" par travail (les lignes vides et commençant par # sont ignorées).
+	* \param manifest_name nom du manifeste.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales), paramètres communs à tous les travaux.
+	* Ici cette fonction utilise aussi le budget mémoire en Mo (memory_budget).
+	* \return nombre de travaux en échec, -1 si le manifeste ne peut pas être lu.
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	time(&t0);
+
+	vector<unique_ptr<batch_job>> jobs;
+	if (read_manifest(manifest_name,jobs,context) == 0){
+		return -1;
+	}
+	cout << endl << "Batch : " << jobs.size() << " jobs, memory budget " << context["memory_budget"] << " MB" << endl;
+
+	memory_budget budget(size_t(context["memory_budget"]*1024*1024));
+	bounded_queue<unique_ptr<batch_job>> to_color(1);
+	bounded_queue<unique_ptr<batch_job>> to_write(1);
+	int nb_failed = 0;
+
+	//étape 1 : lecture et projection des points
+	thread reader([&](){
+		for(auto &job : jobs){
+			budget.acquire(job->points_bytes+job->pixels_bytes);
+			try{
+				if (get_projected_points(job->input,&job->points,job->context) == 0){
+					job->ok = false;
+				}
+				else if (job->context["thinning"] != 0){
+					thin_points(job->points,job->context);
+				}
+			}
+			catch(...){ //mémoire insuffisante...
+				cout << "Lecture impossible : " << job->input << endl;
+				job->ok = false;
+			}
+			to_color.push(move(job));
+		}
+		to_color.close();
+	});
+
+	//étape 2 : triangulation et coloration, les points sont libérés dès que les pixels sont colorés
+	thread colorer([&](){
+		unique_ptr<batch_job> job;
+		while(to_color.pop(job)){
+			if (job->ok){
+				try{
+					if (use_binning(job->points,job->context)){
+						create_pixels(job->pixels,job->pixels_illumination,job->context);
+						bin_n_color(job->points,job->pixels,job->pixels_illumination,job->context);
+					}
+					else{
+						triangulate_n_color(job->points,job->pixels,job->pixels_illumination,job->context); //crée les pixels après la triangulation
+					}
+				}
+				catch(...){ //triangulation impossible (moins de 3 points distincts...)
+					cout << "Triangulation impossible : " << job->input << endl;
+					job->ok = false;
+				}
+			}
+			job->points.clear();
+			budget.release(job->points_bytes);
+			to_write.push(move(job));
+		}
+		to_write.close();
+	});
+
+	//étape 3 (thread appelant) : écriture des images
+	unique_ptr<batch_job> job;
+	while(to_write.pop(job)){
+		if (job->ok && generate_image(job->pixels,job->pixels_illumination,job->context,job->output) == 0){
+			job->ok = false;
+		}
+		cout << endl << "Job " << job->number << " (" << job->input << " -> " << job->output << ") : " << (job->ok ? "done" : "FAILED") << endl;
+		if (!job->ok){
+			nb_failed++;
+		}
+		budget.release(job->pixels_bytes);
+		job.reset();
+	}
+	reader.join();
+	colorer.join();
+
+	time(&tf);
+	cout << endl << "Batch finished : " << jobs.size()-nb_failed << " done, " << nb_failed << " failed (" << tf-t0 << " s)" << endl;
+	return nb_failed;
+}
+
+static int read_manifest(string manifest_name, vector<unique_ptr<batch_job>> &jobs, map<string,double> &context){
+	/**
+	* \brief Lis le manifeste du mode batch et estime la mémoire nécessaire à chaque travail.
+	* \param manifest_name nom du manifeste.
+	* \param jobs vecteur dans lequel stocker les travaux.
+	* \param context paramètres communs à tous les travaux.
+	* \return 1 si le manifeste est valide, 0 sinon.
+	*/
+	ifstream f(manifest_name);
+	if (!f.is_open()){
+		cout << "Echec d'ouverture de " << manifest_name << endl;
+		return 0;
+	}
+	string line;
+	int line_number = 0;
+	while(getline(f,line)){
+		line_number++;
+		istringstream line_stream(line);
+		string input,output;
+		double width = 0;
+		if (!(line_stream >> input) || input[0] == '#'){ //ligne vide ou commentaire
+			continue;
+		}
+		if (!(line_stream >> width >> output) || width <= 0){
+			cout << "Ligne " << line_number << " invalide dans " << manifest_name << " (il faut : fichier largeur image)" << endl;
+			return 0;
+		}
+		unique_ptr<batch_job> job(new batch_job());
+		job->number = jobs.size()+1;
+		job->input = input;
+		job->output = output;
+		job->context = context;
+		job->context["width"] = int(width);
+		job->context["height"] = int(width);
+
+		//estimation de la mémoire : environ 30 octets de texte par point, et par point ses coordonnées et sa profondeur,
+		//la triangulation (environ 2 triangles de 3 indices et 3 demi-arêtes) ; par pixel la couleur, l'illumination et l'image
+		size_t file_size = text_file_size(input); //taille décompressée pour un fichier gzip
+		size_t nb_points = file_size/30;
+		job->points_bytes = nb_points*(3*sizeof(double)+12*sizeof(tin_index)+2); //indices sur 32 bits par défaut (voir struct_point.h)
+		job->pixels_bytes = size_t(width)*size_t(width)*(sizeof(int)+sizeof(double)+3);
+		jobs.push_back(move(job));
+	}
+	return 1;
+}
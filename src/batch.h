@@ -0,0 +1,17 @@
+#include <string>
+#include <map> //dictionnaires
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/**
+* \file batch.h
+* \brief Fichier de déclaration du mode batch : plusieurs relevés sont traités par un pipeline à trois étapes
+* (lecture et projection, triangulation et coloration, écriture de l'image) qui se recouvrent.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int run_batch(std::string manifest_name, std::map<std::string,double> &context);
+
+#endif
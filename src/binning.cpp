@@ -0,0 +1,290 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+#include "struct_point.h"
+#include "Triangle.h"
+#include "triangulation.h"
+#include "shading.h"
+#include "parallel.h"
+#include "binning.h"
+
+/**
+* \file binning.cpp
+* \brief Fichier d'implémentation du rendu par accumulation directe des points dans les pixels, utilisé quand il y a plusieurs points par pixel.
+* La triangulation ne sert plus qu'à remplir les pixels sans points.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+int read_engine(string str, map<string,double> &context){
+	/**
+	* \brief Lis le moteur de rendu : auto (choix selon le nombre de points par pixel), tin (triangulation) ou binning (accumulation).
+	* \param str texte à analyser.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales), initialise engine.
+	* \return 1 si le moteur est valide, 0 sinon.
+	*/
+	vector<string> engines = {"auto","tin","binning"};
+	for(size_t i = 0; i < engines.size(); i++){
+		if (str == engines[i]){
+			context["engine"] = i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int read_binning(string str, map<string,double> &context){
+	/**
+	* \brief Lis la profondeur retenue pour un pixel : mean (moyenne des points), min (le moins profond) ou max (le plus profond).
+	* \param str texte à analyser.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales), initialise binning.
+	* \return 1 si le mode est valide, 0 sinon.
+	*/
+	vector<string> modes = {"mean","min","max"};
+	for(size_t i = 0; i < modes.size(); i++){
+		if (str == modes[i]){
+			context["binning"] = i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+bool use_binning(point_cloud &points, map<string,double> &context){
+	/**
+	* \brief Choisit le moteur de rendu : en mode auto, l'accumulation est utilisée quand le nombre de points par pixel
+	* dépasse binning_threshold.
+	* \param points Points projetés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin du moteur (engine), du seuil (binning_threshold) et de la taille de l'image (width,height).
+	* \return true si les pixels doivent être colorés par accumulation.
+	*/
+	if (context["engine"] != 0){
+		return context["engine"] == 2;
+	}
+	double points_per_pixel = points.size()/(context["width"]*context["height"]);
+	return points_per_pixel >= context["binning_threshold"];
+}
+
+void bin_n_color(point_cloud &points, vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, pixel_channels *channels){
+	/**
+	* \brief Colore les pixels en y accumulant directement les points (moyenne, minimum ou maximum des profondeurs par pixel).
+	* Les points sont répartis par bandes de pixels (histogramme puis dispersion), chaque thread accumule ensuite sa bande seul.
+	* L'illumination vient des pentes entre pixels voisins, puis les pixels restés vides sont remplis par une triangulation
+	* des centres des pixels colorés qui bordent un pixel vide.
+	* \param points Points projetés.
+	* \param pixels Liste des pixels.
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de :
+	* - le mode d'accumulation (binning : 0 = moyenne, 1 = min, 2 = max)
+	* - la taille de l'image et des pixels (width,height,lg_pix,h_pix) et ses limites (min_x,max_y)
+	* - le vecteur lumière et le mode d'ombrage (sun_dir_x,sun_dir_y,sun_dir_z,shading)
+	* - le nombre de threads (nb_threads)
+	* et de ce dont ont besoin les fonctions de triangulation pour remplir les vides (voir triangulate et color_triangles).
+	* \param channels Canaux des pixels à remplir en place (voir pixel_channels), seule la profondeur est remplie par l'accumulation, ignorés si nullptr.
+	*/
+
+	cout << endl<<"Binning and coloration :"<<endl;
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Binning points into pixels...";
+	time(&t0);
+
+	//récupération des variables nécessaires
+	set_raster_parameters(context);
+	int mode = context["binning"];
+	int width = context["width"];
+	int height = context["height"];
+	double lg_pix = context["lg_pix"];
+	double h_pix = context["h_pix"];
+	bool smooth_shading = context["shading"] == 1;
+	int nb_threads = max(1,int(context["nb_threads"]));
+	size_t nb_points = points.size();
+	size_t nb_pixels = pixels.size();
+	size_t nb_bands = nb_threads;
+	size_t band_size = (nb_pixels+nb_bands-1)/nb_bands;
+
+	////////////
+	////ETAPE1//
+	////////////
+
+	//ETAPE1: pixel de chaque point et nombre de points de chaque bande de pixels, par thread
+	vector<int> point_pixel(nb_points);
+	vector<vector<size_t>> band_counts(nb_threads,vector<size_t>(nb_bands,0));
+	parallel_for(nb_points,nb_threads,[&](size_t begin, size_t end, int thread_id){
+		for(size_t i = begin; i < end; i++){
+			point_pixel[i] = pixel_of_point(points[i])-1;
+			band_counts[thread_id][point_pixel[i]/band_size]++;
+		}
+	});
+
+	//position de départ de chaque thread dans chaque bande, les points restent dans l'ordre du fichier
+	vector<size_t> band_begin(nb_bands+1,0);
+	vector<vector<size_t>> offsets(nb_threads,vector<size_t>(nb_bands,0));
+	size_t position = 0;
+	for(size_t b = 0; b < nb_bands; b++){
+		band_begin[b] = position;
+		for(int t = 0; t < nb_threads; t++){
+			offsets[t][b] = position;
+			position += band_counts[t][b];
+		}
+	}
+	band_begin[nb_bands] = position;
+
+	//dispersion des indices des points par bande (même découpage que le comptage)
+	vector<size_t> order(nb_points);
+	parallel_for(nb_points,nb_threads,[&](size_t begin, size_t end, int thread_id){
+		vector<size_t> &offset = offsets[thread_id];
+		for(size_t i = begin; i < end; i++){
+			order[offset[point_pixel[i]/band_size]++] = i;
+		}
+	});
+
+	////////////
+	////ETAPE2//
+	////////////
+
+	//ETAPE2: accumulation des profondeurs, chaque bande de pixels n'est modifiée que par un thread
+	vector<double> pixels_depth(nb_pixels,0);
+	vector<uint32_t> pixels_count(nb_pixels,0);
+	parallel_for(nb_bands,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t b = begin; b < end; b++){
+			for(size_t k = band_begin[b]; k < band_begin[b+1]; k++){
+				double depth = points.depth[order[k]];
+				int p = point_pixel[order[k]];
+				if (pixels_count[p] == 0 || mode == 0){
+					pixels_depth[p] = (pixels_count[p] == 0) ? depth : pixels_depth[p]+depth;
+				}
+				else if ((mode == 1 && depth > pixels_depth[p]) || (mode == 2 && depth < pixels_depth[p])){ //profondeurs négatives
+					pixels_depth[p] = depth;
+				}
+				pixels_count[p]++;
+			}
+			size_t last = min(nb_pixels,(b+1)*band_size);
+			for(size_t p = b*band_size; p < last; p++){
+				if (pixels_count[p] != 0){
+					if (mode == 0){
+						pixels_depth[p] /= pixels_count[p];
+					}
+					pixels[p] = convert_to_color(pixels_depth[p]);
+					if (channels != nullptr && channels->depth != nullptr){
+						channels->depth[p] = pixels_depth[p];
+					}
+				}
+			}
+		}
+	});
+	vector<int>().swap(point_pixel);
+	vector<size_t>().swap(order);
+
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+
+	////////////
+	////ETAPE3//
+	////////////
+
+	//ETAPE3: illumination des pixels colorés à partir des pentes vers les pixels voisins (différences centrées si possible)
+	cout << "- Shading binned pixels...";
+	time(&t0);
+	vector<double> sun_dir = {context["sun_dir_x"],context["sun_dir_y"],context["sun_dir_z"]};
+	normal_buffer pixels_normals;
+	if (smooth_shading){
+		pixels_normals.x.assign(nb_pixels,0);
+		pixels_normals.y.assign(nb_pixels,0);
+		pixels_normals.z.assign(nb_pixels,0);
+	}
+	parallel_for(height,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t y = begin; y < end; y++){
+			for(int x = 0; x < width; x++){
+				size_t p = y*width+x;
+				if (pixels_count[p] == 0){
+					continue;
+				}
+				bool left = x > 0 && pixels_count[p-1] != 0;
+				bool right = x < width-1 && pixels_count[p+1] != 0;
+				bool up = y > 0 && pixels_count[p-width] != 0; //vers le nord
+				bool down = int(y) < height-1 && pixels_count[p+width] != 0;
+				double d_left = left ? pixels_depth[p-1] : pixels_depth[p];
+				double d_right = right ? pixels_depth[p+1] : pixels_depth[p];
+				double d_up = up ? pixels_depth[p-width] : pixels_depth[p];
+				double d_down = down ? pixels_depth[p+width] : pixels_depth[p];
+				double gx = (left || right) ? (d_right-d_left)/((left+right)*lg_pix) : 0;
+				double gy = (up || down) ? (d_up-d_down)/((up+down)*h_pix) : 0;
+
+				//plan du pixel : normale (-gx,-gy,1), même orientation que les triangles de delaunator
+				point a = {0,0,0};
+				point b = {0,1,gy};
+				point c = {1,0,gx};
+				Triangle T = Triangle(a,b,c);
+				T.compute_illumination(sun_dir);
+				pixels_illumination[p] = T.illumination;
+				if (smooth_shading){
+					pixels_normals.x[p] = -gx;
+					pixels_normals.y[p] = -gy;
+					pixels_normals.z[p] = 1;
+				}
+			}
+		}
+	});
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+
+	////////////
+	////ETAPE4//
+	////////////
+
+	//ETAPE4: centres des pixels colorés voisins d'un pixel vide, triangulés pour remplir les vides
+	point_cloud border;
+	for(int y = 0; y < height; y++){
+		for(int x = 0; x < width; x++){
+			size_t p = size_t(y)*width+x;
+			if (pixels_count[p] == 0){
+				continue;
+			}
+			bool near_empty = false;
+			for(int dy = max(0,y-1); dy <= min(height-1,y+1) && !near_empty; dy++){
+				for(int dx = max(0,x-1); dx <= min(width-1,x+1); dx++){
+					if (pixels_count[size_t(dy)*width+dx] == 0){
+						near_empty = true;
+						break;
+					}
+				}
+			}
+			if (near_empty){
+				double center_x = ((x+1)*lg_pix+context["min_x"])-(lg_pix/2);
+				double center_y = (context["max_y"]-((y+1)*h_pix))+(h_pix/2);
+				border.push_back({center_x,center_y,pixels_depth[p]});
+			}
+		}
+	}
+	vector<double>().swap(pixels_depth);
+	vector<uint32_t>().swap(pixels_count);
+
+	if (border.size() >= 3){
+		//les centres sont espacés d'un pixel, comme des points réduits à un par pixel (voir thinning.cpp)
+		context["thinning_cell"] = max(context["thinning_cell"],max(lg_pix,h_pix));
+		tin t;
+		triangulate(border,t,context);
+		color_triangles(border,t,pixels,pixels_illumination,context,nullptr,smooth_shading ? &pixels_normals : nullptr,channels);
+		return;
+	}
+
+	//pas de vides à remplir : ombrages directement
+	if (smooth_shading){
+		compute_smooth_illumination(pixels_normals,pixels_illumination,context);
+	}
+	if (context["shadows"] == 1){
+		compute_cast_shadows(pixels,pixels_illumination,context);
+	}
+}
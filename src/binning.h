@@ -0,0 +1,23 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "dem.h"
+
+#ifndef BINNING_H
+#define BINNING_H
+
+/**
+* \file binning.h
+* \brief Fichier de déclaration du rendu par accumulation directe des points dans les pixels, utilisé quand il y a plusieurs points par pixel.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int read_engine(std::string str, std::map<std::string,double> &context);
+int read_binning(std::string str, std::map<std::string,double> &context);
+bool use_binning(point_cloud &points, std::map<std::string,double> &context);
+void bin_n_color(point_cloud &points, std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context, pixel_channels *channels = nullptr);
+
+#endif
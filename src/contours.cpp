@@ -0,0 +1,268 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <sstream>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <cmath>
+#include <ctime> //temps, mesures d'executions
+#include <algorithm>
+#include "parallel.h"
+#include "init_points_pixels.h"
+#include "contours.h"
+
+/**
+* \file contours.cpp
+* \brief Fichier d'implémentation de l'extraction des isobathes par marching triangles sur la triangulation conservée.
+* Pour chaque profondeur, un triangle est traversé par l'isobathe si ses sommets sont de part et d'autre : la ligne entre
+* par le coté qui va d'un sommet au dessus (profondeur >= niveau) à un sommet en dessous, et sort par le coté opposé.
+* Les segments sont reliés en polylignes en passant au triangle voisin par la demi-arête opposée (halfedges).
+* Le coût est linéaire en nombre de triangles et ne dépend pas de la taille de l'image.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static void contour_levels(map<string,double> &context, vector<double> &levels);
+static void trace_level(point_cloud &points, tin &t, double level, int nb_threads, vector<vector<double>> &lines);
+static void write_geojson(ofstream &f, vector<double> &levels, vector<vector<vector<double>>> &lines);
+static void write_wkt(ofstream &f, vector<double> &levels, vector<vector<vector<double>>> &lines);
+
+int read_contour_levels(string str, map<string,double> &context){
+	/**
+	* \brief Lis une liste de profondeurs d'isobathes sous la forme "p1,p2,...", dans l'unité des profondeurs du relevé
+	* (positives ou négatives).
+	* Les niveaux sont ajoutés à context (nb_contour_levels, contour_level_i).
+	* \param str texte à analyser.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \return 1 si la liste est valide, 0 sinon.
+	*/
+	istringstream list_stream(str);
+	string item;
+	int nb_levels = 0;
+	while(getline(list_stream,item,',')){
+		try{
+			double level = stod(item);
+			context["contour_level_"+to_string(nb_levels)] = (level > 0) ? -level : level; //profondeurs négatives (voir get_point)
+		}
+		catch(...){
+			return 0;
+		}
+		nb_levels++;
+	}
+	if (nb_levels == 0){
+		return 0;
+	}
+	context["nb_contour_levels"] = nb_levels;
+	return 1;
+}
+
+int export_contours(string file_name, point_cloud &points, tin &t, map<string,double> &context){
+	/**
+	* \brief Extrait les isobathes de la triangulation et les écrit en GeoJSON (.geojson, .json) ou en WKT (autres extensions).
+	* \param file_name fichier à créer.
+	* \param points Points de la triangulation.
+	* \param t Triangulation, avec ses demi-arêtes et ses triangles conservés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin :
+	* - des profondeurs des isobathes (nb_contour_levels, contour_level_i) ou de leur intervalle (contour_interval)
+	* et des limites de profondeur (min_depth,max_depth)
+	* - des coordonnées de sortie (contour_geographic : 0 = projetées en m, 1 = longitude, latitude)
+	* - du nombre de threads (nb_threads)
+	* \return 1 si le fichier a été écrit, 0 sinon.
+	*/
+	time_t t0,tf;
+	cout << "- Extracting isobaths...";
+	time(&t0);
+
+	vector<double> levels;
+	contour_levels(context,levels);
+	int nb_threads = context["nb_threads"];
+	vector<vector<vector<double>>> lines(levels.size()); //polylignes {x0,y0,x1,y1...} de chaque niveau
+	size_t nb_lines = 0;
+	for(size_t l = 0; l < levels.size(); l++){
+		trace_level(points,t,levels[l],nb_threads,lines[l]);
+		nb_lines += lines[l].size();
+	}
+
+	//conversion en coordonnées géographiques
+	if (context["contour_geographic"] == 1){
+		for(size_t l = 0; l < lines.size(); l++){
+			for(size_t k = 0; k < lines[l].size(); k++){
+				if (!unproject_coords(lines[l][k])){ //(Voir init_points_pixels.cpp)
+					cout << "Echec de la conversion des isobathes en coordonnées géographiques" << endl;
+					return 0;
+				}
+			}
+		}
+	}
+
+	ofstream f(file_name);
+	if (!f.is_open()){
+		cout << "Impossible de créer " << file_name << endl;
+		return 0;
+	}
+	f.precision(12);
+	string extension = file_name.substr(file_name.find_last_of('.')+1);
+	if (extension == "geojson" || extension == "json"){
+		write_geojson(f,levels,lines);
+	}
+	else{
+		write_wkt(f,levels,lines);
+	}
+	f.close();
+
+	time(&tf);
+	cout << " " << levels.size() << " levels, " << nb_lines << " lines (" << tf-t0 << " s)" << endl;
+	return 1;
+}
+
+static void contour_levels(map<string,double> &context, vector<double> &levels){
+	/**
+	* \brief Renvoie les profondeurs des isobathes : la liste donnée (contour_level_i), sinon les multiples de contour_interval
+	* compris dans les profondeurs du relevé.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param levels Vecteur dans lequel stocker les profondeurs.
+	*/
+	int nb_levels = context["nb_contour_levels"];
+	for(int i = 0; i < nb_levels; i++){
+		levels.push_back(context["contour_level_"+to_string(i)]);
+	}
+	double interval = context["contour_interval"];
+	if (nb_levels == 0 && interval > 0){
+		double low = min(context["min_depth"],context["max_depth"]);
+		double high = max(context["min_depth"],context["max_depth"]);
+		for(double level = ceil(low/interval)*interval; level <= high; level += interval){
+			levels.push_back(level);
+		}
+	}
+}
+
+static void trace_level(point_cloud &points, tin &t, double level, int nb_threads, vector<vector<double>> &lines){
+	/**
+	* \brief Trace l'isobathe d'une profondeur : classement des triangles par blocs en parallèle, puis assemblage des segments.
+	* \param points Points de la triangulation.
+	* \param t Triangulation.
+	* \param level profondeur de l'isobathe.
+	* \param nb_threads nombre de threads.
+	* \param lines Vecteur dans lequel ajouter les polylignes {x0,y0,x1,y1...}, fermées si le premier et le dernier point sont égaux.
+	*/
+	size_t nb_triangles = t.triangles.size()/3;
+
+	//coté d'entrée de l'isobathe dans chaque triangle (0, 1 ou 2), -1 si elle ne le traverse pas
+	vector<signed char> entry(nb_triangles,-1);
+	parallel_for(nb_triangles,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			if (!t.kept[i]){
+				continue;
+			}
+			for(int k = 0; k < 3; k++){
+				bool from_above = points.depth[t.triangles[3*i+k]] >= level;
+				bool to_above = points.depth[t.triangles[3*i+(k+1)%3]] >= level;
+				if (from_above && !to_above){
+					entry[i] = k;
+				}
+			}
+		}
+	});
+
+	//point de l'isobathe sur la demi-arête e, calculé de la même façon pour les deux triangles qui la partagent
+	auto crossing = [&](size_t e, vector<double> &line){
+		tin_index a = t.triangles[e];
+		tin_index b = t.triangles[(e%3 == 2) ? e-2 : e+1];
+		if (a > b){
+			swap(a,b);
+		}
+		double r = (level-points.depth[a])/(points.depth[b]-points.depth[a]);
+		line.push_back(points.x(a)+r*(points.x(b)-points.x(a)));
+		line.push_back(points.y(a)+r*(points.y(b)-points.y(a)));
+	};
+	//demi-arête opposée par laquelle la ligne entre dans le triangle voisin, no_halfedge s'il n'y en a pas
+	auto neighbour = [&](size_t e){
+		tin_index twin = t.halfedges[e];
+		return (twin != no_halfedge && t.kept[twin/3]) ? twin : no_halfedge;
+	};
+
+	//assemblage : les lignes ouvertes partent du bord de la triangulation, puis il ne reste que des lignes fermées
+	for(int pass = 0; pass < 2; pass++){
+		for(size_t i = 0; i < nb_triangles; i++){
+			if (entry[i] < 0 || (pass == 0 && neighbour(3*i+entry[i]) != no_halfedge)){
+				continue;
+			}
+			vector<double> line;
+			crossing(3*i+entry[i],line);
+			size_t current = i;
+			while(true){
+				//coté de sortie : le seul autre coté qui va d'un sommet en dessous à un sommet au dessus
+				size_t exit_edge = 0;
+				for(int k = 0; k < 3; k++){
+					bool from_above = points.depth[t.triangles[3*current+k]] >= level;
+					bool to_above = points.depth[t.triangles[3*current+(k+1)%3]] >= level;
+					if (!from_above && to_above){
+						exit_edge = 3*current+k;
+					}
+				}
+				entry[current] = -1;
+				crossing(exit_edge,line);
+				tin_index next = neighbour(exit_edge);
+				if (next == no_halfedge || entry[next/3] < 0){ //bord de la triangulation ou ligne refermée
+					break;
+				}
+				current = next/3;
+			}
+			lines.push_back(move(line));
+		}
+	}
+}
+
+static void write_geojson(ofstream &f, vector<double> &levels, vector<vector<vector<double>>> &lines){
+	/**
+	* \brief Écrit les isobathes en GeoJSON : une Feature MultiLineString par profondeur, avec la propriété "depth".
+	* \param f fichier ouvert.
+	* \param levels profondeurs des isobathes.
+	* \param lines polylignes de chaque profondeur.
+	*/
+	f << "{\"type\":\"FeatureCollection\",\"features\":[" << endl;
+	for(size_t l = 0; l < levels.size(); l++){
+		f << "{\"type\":\"Feature\",\"properties\":{\"depth\":" << levels[l] << "},\"geometry\":{\"type\":\"MultiLineString\",\"coordinates\":[";
+		for(size_t k = 0; k < lines[l].size(); k++){
+			vector<double> &line = lines[l][k];
+			f << ((k == 0) ? "[" : ",[");
+			for(size_t i = 0; i < line.size(); i+=2){
+				f << ((i == 0) ? "[" : ",[") << line[i] << "," << line[i+1] << "]";
+			}
+			f << "]";
+		}
+		f << "]}}" << ((l+1 < levels.size()) ? "," : "") << endl;
+	}
+	f << "]}" << endl;
+}
+
+static void write_wkt(ofstream &f, vector<double> &levels, vector<vector<vector<double>>> &lines){
+	/**
+	* \brief Écrit les isobathes en texte délimité "profondeur;géométrie WKT", une ligne MULTILINESTRING par profondeur.
+	* \param f fichier ouvert.
+	* \param levels profondeurs des isobathes.
+	* \param lines polylignes de chaque profondeur.
+	*/
+	f << "depth;wkt" << endl;
+	for(size_t l = 0; l < levels.size(); l++){
+		f << levels[l] << ";MULTILINESTRING ";
+		if (lines[l].empty()){
+			f << "EMPTY" << endl;
+			continue;
+		}
+		f << "(";
+		for(size_t k = 0; k < lines[l].size(); k++){
+			vector<double> &line = lines[l][k];
+			f << ((k == 0) ? "(" : ", (");
+			for(size_t i = 0; i < line.size(); i+=2){
+				f << ((i == 0) ? "" : ", ") << line[i] << " " << line[i+1];
+			}
+			f << ")";
+		}
+		f << ")" << endl;
+	}
+}
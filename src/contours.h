@@ -0,0 +1,21 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+
+#ifndef CONTOURS_H
+#define CONTOURS_H
+
+/**
+* \file contours.h
+* \brief Fichier de déclaration de l'extraction des isobathes (courbes de niveau) sur la triangulation.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int read_contour_levels(std::string str, std::map<std::string,double> &context);
+int export_contours(std::string file_name, point_cloud &points, tin &t, std::map<std::string,double> &context);
+
+#endif
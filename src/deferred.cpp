@@ -0,0 +1,150 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "parallel.h"
+#include "Triangle.h"
+#include "triangulation.h"
+#include "init_points_pixels.h"
+#include "shading.h"
+#include "dem.h"
+#include "deferred.h"
+
+/**
+* \file deferred.cpp
+* \brief Fichier d'implémentation du rendu différé.
+* La rasterisation (color_triangles) écrit une seule fois le triangle qui colore chaque pixel (canal triangle, voir pixel_channels),
+* avec la couleur des pixels qui ne dépend que de leur profondeur. Un nouvel éclairage ne calcule ensuite que l'illumination
+* des triangles visibles, recopiée dans les pixels, puis l'ombrage lisse et les ombres portées qui travaillent déjà sur les pixels.
+* L'image obtenue est identique à celle d'un rendu complet.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+void capture_deferred(point_cloud &points, tin &t, map<string,double> &context, const vector<size_t> *selection, deferred_raster &raster, vector<double> &pixels_illumination){
+	/**
+	* \brief Rasterise une image dans un tampon de visibilité, sans ombrage.
+	* \param points Points de la triangulation.
+	* \param t Triangulation à rendre.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise la taille et les limites de l'image, le mode d'ombrage (shading : normales des pixels
+	* calculées seulement pour l'ombrage lisse) et le nombre de threads (nb_threads).
+	* \param selection Indices des triangles à considérer (tous les triangles si nullptr).
+	* \param raster Tampon à remplir.
+	* \param pixels_illumination Vecteur des illuminations des pixels, utilisé pendant la rasterisation.
+	*/
+	int width = context["width"];
+	raster.pixels.clear();
+	create_pixels(raster.pixels,pixels_illumination,context);
+	size_t nb_pixels = raster.pixels.size();
+	raster.triangles.assign(nb_pixels,no_halfedge);
+
+	//rasterisation sans ombrage, le canal triangle reçoit l'indice du triangle de chaque pixel
+	map<string,double> raster_context = context;
+	raster_context["shading"] = 0;
+	raster_context["shadows"] = 0;
+	pixel_channels channels;
+	channels.triangle = raster.triangles.data();
+	color_triangles(points,t,raster.pixels,pixels_illumination,raster_context,selection,nullptr,&channels);
+
+	//normales des pixels pour l'ombrage lisse, interpolées comme dans find_pixels
+	raster.normals = normal_buffer();
+	int nb_threads = context["nb_threads"];
+	if (context["shading"] == 1){
+		if (t.vertex_normals.empty()){
+			compute_vertex_normals(points,t.triangles,t.kept,t.vertex_normals,nb_threads);
+		}
+		raster.normals.x.assign(nb_pixels,0);
+		raster.normals.y.assign(nb_pixels,0);
+		raster.normals.z.assign(nb_pixels,0);
+		double lg_pix = context["lg_pix"];
+		double h_pix = context["h_pix"];
+		double min_x = context["min_x"];
+		double max_y = context["max_y"];
+		parallel_for(nb_pixels,nb_threads,[&](size_t begin, size_t end, int){
+			for(size_t p = begin; p < end; p++){
+				size_t i = raster.triangles[p];
+				if (i == no_halfedge){
+					continue;
+				}
+				int x = p%width+1;
+				int y = p/width+1;
+				double center_x = ((x*lg_pix)+min_x)-(lg_pix/2);
+				double center_y = (max_y-(y*h_pix))+(h_pix/2);
+				Triangle T(points[t.triangles[3*i]],points[t.triangles[3*i+1]],points[t.triangles[3*i+2]]);
+				T.n1 = &(t.vertex_normals[3*t.triangles[3*i]]);
+				T.n2 = &(t.vertex_normals[3*t.triangles[3*i+1]]);
+				T.n3 = &(t.vertex_normals[3*t.triangles[3*i+2]]);
+				float n[3];
+				T.interpolate_normal(center_x,center_y,n);
+				raster.normals.x[p] = n[0];
+				raster.normals.y[p] = n[1];
+				raster.normals.z[p] = n[2];
+			}
+		});
+	}
+
+	//renumérotation des triangles visibles et stockage de leurs vecteurs normaux
+	vector<tin_index> visible(t.triangles.size()/3,no_halfedge);
+	raster.face_normals.clear();
+	for(size_t p = 0; p < nb_pixels; p++){
+		tin_index i = raster.triangles[p];
+		if (i == no_halfedge){
+			continue;
+		}
+		if (visible[i] == no_halfedge){
+			visible[i] = raster.face_normals.size()/3;
+			Triangle T(points[t.triangles[3*i]],points[t.triangles[3*i+1]],points[t.triangles[3*i+2]]);
+			raster.face_normals.insert(raster.face_normals.end(),T.vn.begin(),T.vn.end());
+		}
+		raster.triangles[p] = visible[i];
+	}
+}
+
+void shade_deferred(deferred_raster &raster, map<string,double> &context, vector<double> &pixels_illumination){
+	/**
+	* \brief Calcule l'illumination des pixels d'un tampon de visibilité, comme color_triangles.
+	* \param raster Tampon rempli par capture_deferred.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise la direction du soleil (sun_dir_x,sun_dir_y,sun_dir_z), le mode d'ombrage (shading, lumières),
+	* les ombres portées (shadows, voir compute_cast_shadows) et le nombre de threads (nb_threads).
+	* \param pixels_illumination Vecteur dans lequel stocker les illuminations des pixels.
+	*/
+	set_raster_parameters(context); //pour convert_to_depth (ombres portées)
+	int nb_threads = context["nb_threads"];
+	double light[3] = {context["sun_dir_x"],context["sun_dir_y"],context["sun_dir_z"]};
+
+	//illumination des triangles visibles
+	size_t nb_faces = raster.face_normals.size()/3;
+	vector<double> faces_illumination(nb_faces);
+	parallel_for(nb_faces,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t k = begin; k < end; k++){
+			faces_illumination[k] = face_illumination(light,&raster.face_normals[3*k]); //(Voir Triangle.cpp)
+		}
+	});
+
+	//recopie dans les pixels (illumination maximale pour les pixels non colorés, voir create_pixels)
+	size_t nb_pixels = raster.pixels.size();
+	pixels_illumination.resize(nb_pixels);
+	parallel_for(nb_pixels,nb_threads,[&](size_t begin, size_t end, int){
+		const tin_index* __restrict triangles = raster.triangles.data();
+		double* __restrict illumination = pixels_illumination.data();
+		for(size_t p = begin; p < end; p++){
+			illumination[p] = (triangles[p] != no_halfedge) ? faces_illumination[triangles[p]] : 1;
+		}
+	});
+
+	//ombrage lisse à partir d'une copie des normales (normalisées sur place)
+	if (context["shading"] == 1 && raster.normals.z.size() == nb_pixels){
+		normal_buffer normals = raster.normals;
+		compute_smooth_illumination(normals,pixels_illumination,context);
+	}
+
+	//ombres portées par le relief
+	if (context["shadows"] == 1){
+		compute_cast_shadows(raster.pixels,pixels_illumination,context);
+	}
+}
@@ -0,0 +1,38 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+#include "shading.h"
+
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+/**
+* \file deferred.h
+* \brief Fichier de déclaration du rendu différé : tampon de visibilité (triangle de chaque pixel) rendu une fois,
+* puis ombrage et coloration recalculés sans nouvelle rasterisation quand seuls le soleil, les lumières ou la colormap changent.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+struct deferred_raster
+{
+	/**
+	* \brief Résultat de la rasterisation d'une image, indépendant de l'éclairage.
+	* \param triangles triangle visible de chaque pixel, indice dans face_normals (no_halfedge si le pixel n'est pas coloré).
+	* \param pixels couleurs des pixels (profondeurs converties, voir convert_to_color).
+	* \param normals normales interpolées des pixels (ombrage lisse uniquement), non normalisées.
+	* \param face_normals vecteurs normaux des triangles visibles {nx0,ny0,nz0,...} (voir Triangle).
+	*/
+	std::vector<tin_index> triangles;
+	std::vector<int> pixels;
+	normal_buffer normals;
+	std::vector<double> face_normals;
+};
+
+void capture_deferred(point_cloud &points, tin &t, std::map<std::string,double> &context, const std::vector<std::size_t> *selection, deferred_raster &raster, std::vector<double> &pixels_illumination);
+void shade_deferred(deferred_raster &raster, std::map<std::string,double> &context, std::vector<double> &pixels_illumination);
+
+#endif
@@ -0,0 +1,125 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h> //projection du fichier en mémoire
+#include "parallel.h"
+#include "init_points_pixels.h"
+#include "dem.h"
+
+/**
+* \file dem.cpp
+* \brief Fichier d'implémentation de la sortie du modèle numérique de terrain.
+* Le fichier est au format ESRI BIL (float32 little endian, une bande) : les profondeurs brutes dans le .bil,
+* le géoréférencement dans le .hdr et le système de coordonnées dans le .prj, lisibles par GDAL/QGIS.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static string sidecar_name(string file_name, string extension);
+
+int create_dem(string file_name, map<string,double> &context, dem_raster &dem){
+	/**
+	* \brief Crée le fichier du modèle numérique de terrain à la taille de l'image et le projette en mémoire,
+	* tous les pixels valant dem_nodata.
+	* \param file_name fichier de données à créer (.bil).
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la taille de l'image (width,height) et du nombre de threads (nb_threads).
+	* \param dem Modèle numérique de terrain à initialiser.
+	* \return 1 si le fichier a été créé, 0 sinon.
+	*/
+	dem.file_name = file_name;
+	dem.nb_pixels = size_t(context["width"])*size_t(context["height"]);
+	size_t size = dem.nb_pixels*sizeof(float);
+
+	dem.fd = open(file_name.c_str(),O_RDWR|O_CREAT|O_TRUNC,0644);
+	if (dem.fd < 0 || ftruncate(dem.fd,size) != 0){
+		cout << "Impossible de créer " << file_name << endl;
+		return 0;
+	}
+	void *map = mmap(nullptr,max<size_t>(size,1),PROT_READ|PROT_WRITE,MAP_SHARED,dem.fd,0);
+	if (map == MAP_FAILED){
+		cout << "Impossible de projeter " << file_name << " en mémoire" << endl;
+		close(dem.fd);
+		dem.fd = -1;
+		return 0;
+	}
+	dem.data = static_cast<float*>(map);
+
+	parallel_for(dem.nb_pixels,context["nb_threads"],[&](size_t begin, size_t end, int){
+		fill(dem.data+begin,dem.data+end,dem_nodata);
+	});
+	return 1;
+}
+
+int close_dem(dem_raster &dem, map<string,double> &context){
+	/**
+	* \brief Termine le modèle numérique de terrain : les pages modifiées sont écrites dans le fichier,
+	* puis le géoréférencement (.hdr) et le système de coordonnées (.prj) sont écrits à coté.
+	* \param dem Modèle numérique de terrain à fermer.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la taille de l'image (width,height,lg_pix,h_pix) et de ses limites (min_x,max_y).
+	* \return 1 si les fichiers ont été écrits, 0 sinon.
+	*/
+	if (dem.data == nullptr){
+		return 0;
+	}
+	size_t size = dem.nb_pixels*sizeof(float);
+	int result = msync(dem.data,max<size_t>(size,1),MS_SYNC) == 0;
+	munmap(dem.data,max<size_t>(size,1));
+	close(dem.fd);
+	dem.data = nullptr;
+	dem.fd = -1;
+
+	//géoréférencement : coordonnées du centre du pixel en haut à gauche et taille des pixels
+	ofstream header(sidecar_name(dem.file_name,"hdr"));
+	header.precision(15);
+	header << "BYTEORDER I" << endl;
+	header << "LAYOUT BIL" << endl;
+	header << "NROWS " << int(context["height"]) << endl;
+	header << "NCOLS " << int(context["width"]) << endl;
+	header << "NBANDS 1" << endl;
+	header << "NBITS 32" << endl;
+	header << "PIXELTYPE FLOAT" << endl;
+	header << "ULXMAP " << context["min_x"]+context["lg_pix"]/2 << endl;
+	header << "ULYMAP " << context["max_y"]-context["h_pix"]/2 << endl;
+	header << "XDIM " << context["lg_pix"] << endl;
+	header << "YDIM " << context["h_pix"] << endl;
+	header << "NODATA " << dem_nodata << endl;
+	header.close();
+	result = result && !header.fail();
+
+	//système de coordonnées
+	string wkt = projection_wkt();
+	if (wkt != ""){
+		ofstream prj(sidecar_name(dem.file_name,"prj"));
+		prj << wkt << endl;
+	}
+
+	if (result){
+		cout << "DEM written to " << dem.file_name << endl;
+	}
+	else{
+		cout << "Erreur d'écriture de " << dem.file_name << endl;
+	}
+	return result;
+}
+
+static string sidecar_name(string file_name, string extension){
+	/**
+	* \brief Renvoie le nom d'un fichier associé au fichier de données (même nom, autre extension).
+	*/
+	size_t dot = file_name.find_last_of('.');
+	size_t slash = file_name.find_last_of('/');
+	if (dot == string::npos || (slash != string::npos && dot < slash)){
+		return file_name+"."+extension;
+	}
+	return file_name.substr(0,dot+1)+extension;
+}
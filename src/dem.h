@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+
+#ifndef DEM_H
+#define DEM_H
+
+/**
+* \file dem.h
+* \brief Fichier de déclaration de la sortie du modèle numérique de terrain (profondeurs float32 des pixels, fichier projeté en mémoire).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+struct dem_raster
+{
+	/**
+	* \brief Modèle numérique de terrain dont les profondeurs sont écrites directement dans le fichier (mmap) par le rendu.
+	* \param data profondeurs des pixels, dans l'ordre des pixels de l'image (ligne du haut en premier).
+	* \param nb_pixels nombre de pixels.
+	* \param fd descripteur du fichier.
+	* \param file_name nom du fichier de données (.bil).
+	*/
+	float *data = nullptr;
+	std::size_t nb_pixels = 0;
+	int fd = -1;
+	std::string file_name;
+};
+
+struct pixel_channels
+{
+	/**
+	* \brief Canaux en float remplis par le rendu en même temps que les couleurs, dans l'ordre des pixels de l'image.
+	* Un canal à nullptr n'est pas calculé, et les canaux dérivés des plans des triangles ne coûtent rien s'ils sont tous absents
+	* (le parcours des pixels est instancié à la compilation pour chaque combinaison de canaux, voir find_pixels).
+	* \param depth profondeurs des pixels (modèle numérique de terrain).
+	* \param slope pentes en degrés.
+	* \param aspect orientations des pentes en degrés dans le sens horaire depuis le nord (dem_nodata si plat).
+	* \param rugosity rapports entre la surface du relief et sa projection horizontale (>= 1).
+	* \param triangle indices dans la triangulation des triangles qui colorent les pixels (tampon de visibilité, voir deferred.h).
+	*/
+	float *depth = nullptr;
+	float *slope = nullptr;
+	float *aspect = nullptr;
+	float *rugosity = nullptr;
+	tin_index *triangle = nullptr;
+};
+
+//valeur des pixels sans profondeur
+const float dem_nodata = -99999;
+
+int create_dem(std::string file_name, std::map<std::string,double> &context, dem_raster &dem);
+int close_dem(dem_raster &dem, std::map<std::string,double> &context);
+
+#endif
@@ -0,0 +1,245 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <cmath>
+#include <ctime> //temps, mesures d'executions
+#include <thread> //threads
+#include <algorithm>
+#include "struct_point.h"
+#include "Triangle.h"
+#include "triangulation.h"
+#include "init_points_pixels.h"
+#include "generate_image.h"
+#include "thinning.h"
+#include "dem.h"
+#include "memory.h"
+#include "difference.h"
+
+/**
+* \file difference.cpp
+* \brief Fichier d'implémentation du mode différence.
+* Les deux relevés sont lus et triangulés en parallèle, puis rasterisés sur la même grille de pixels : la zone où ils
+* se recouvrent, avec les mêmes min_x, max_y et taille de pixel. Seuls les triangles qui touchent cette zone sont parcourus.
+* Le premier relevé donne une profondeur par pixel, puis le second est rasterisé en une seule passe qui calcule
+* directement l'écart (second - premier) : positif là où le fond est remonté, négatif là où il s'est creusé.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct survey
+{
+	/**
+	* \brief Relevé du mode différence.
+	* \param points Nuage de points projetés.
+	* \param t Triangulation du relevé.
+	* \param context Paramètres propres au relevé (limites du nuage de points...).
+	* \param ok 1 si le relevé a été lu et triangulé.
+	*/
+	point_cloud points;
+	tin t;
+	map<string,double> context;
+	int ok = 0;
+};
+
+static void prepare_survey(string file_name, survey &s);
+template <typename F>
+static void scan_triangles(survey &s, map<string,double> &context, F visit);
+
+int run_difference(string file_a, string file_b, map<string,double> &context, map<string,string> &paths){
+	/**
+	* \brief Rend l'écart de profondeur entre deux relevés dans raster.ppm (et dans un modèle numérique de terrain si --dem est donné).
+	* \param file_a fichier du premier relevé (référence).
+	* \param file_b fichier du second relevé.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la taille de l'image (width,height), du nombre de threads (nb_threads)
+	* et de l'écart représenté par les extrémités de la colormap (difference_range, 0 = plus grand écart).
+	* Les limites de l'image (min_x,max_x,min_y,max_y) y sont remplacées par celles de la zone de recouvrement.
+	* \param paths Dictionnaire des chemins donnés en options (dem).
+	* \return 1 si l'image a été générée, 0 sinon.
+	*/
+
+	//lecture et triangulation des deux relevés en parallèle, chacun avec la moitié des threads
+	cout << endl << "Surveys initialisation and triangulation :" << endl;
+	survey a, b;
+	a.context = context;
+	b.context = context;
+	a.context["nb_threads"] = max(1,int(context["nb_threads"])/2);
+	b.context["nb_threads"] = max(1,int(context["nb_threads"])-int(a.context["nb_threads"]));
+	thread first([&](){ prepare_survey(file_a,a); });
+	prepare_survey(file_b,b);
+	first.join();
+	if (!a.ok || !b.ok){
+		return 0;
+	}
+	memory_stage("triangulation",context); //(Voir memory.cpp)
+
+	//grille commune : zone de recouvrement des deux relevés
+	context["min_x"] = max(a.context["min_x"],b.context["min_x"]);
+	context["max_x"] = min(a.context["max_x"],b.context["max_x"]);
+	context["min_y"] = max(a.context["min_y"],b.context["min_y"]);
+	context["max_y"] = min(a.context["max_y"],b.context["max_y"]);
+	if (context["min_x"] >= context["max_x"] || context["min_y"] >= context["max_y"]){
+		cout << "Les relevés " << file_a << " et " << file_b << " ne se recouvrent pas" << endl;
+		return 0;
+	}
+	set_pixel_size(context); //(Voir init_points_pixels.cpp)
+
+	vector<int> pixels;
+	vector<double> pixels_illumination;
+	create_pixels(pixels,pixels_illumination,context);
+	size_t nb_pixels = pixels.size();
+
+	//écarts écrits directement dans le modèle numérique de terrain s'il est demandé
+	dem_raster dem;
+	if (paths["dem"] != "" && !create_dem(paths["dem"],context,dem)){ //(Voir dem.cpp)
+		return 0;
+	}
+	vector<float> own_delta;
+	float *delta = dem.data;
+	if (delta == nullptr){
+		own_delta.assign(nb_pixels,dem_nodata);
+		delta = own_delta.data();
+	}
+
+	//profondeurs du premier relevé, le premier triangle qui contient le centre d'un pixel lui donne sa profondeur
+	time_t t0,tf;
+	cout << "- Rasterizing the reference survey...";
+	time(&t0);
+	vector<float> depth_a(nb_pixels,dem_nodata);
+	scan_triangles(a,context,[&](size_t i, double depth){
+		if (depth_a[i] == dem_nodata){
+			depth_a[i] = depth;
+		}
+	});
+	a = survey(); //le premier relevé ne sert plus
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl;
+
+	//passe fusionnée : rasterisation du second relevé et écart avec le premier
+	cout << "- Rasterizing the second survey and differencing...";
+	time(&t0);
+	scan_triangles(b,context,[&](size_t i, double depth){
+		if (delta[i] == dem_nodata && depth_a[i] != dem_nodata){
+			delta[i] = float(depth)-depth_a[i]; //même précision que les profondeurs du premier relevé
+		}
+	});
+	b = survey();
+	vector<float>().swap(depth_a);
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl;
+	memory_stage("difference",context);
+
+	//statistiques des écarts
+	size_t nb_covered = 0;
+	double sum = 0, min_delta = 0, max_delta = 0;
+	for(size_t i = 0; i < nb_pixels; i++){
+		if (delta[i] != dem_nodata){
+			min_delta = (nb_covered == 0) ? delta[i] : min(min_delta,double(delta[i]));
+			max_delta = (nb_covered == 0) ? delta[i] : max(max_delta,double(delta[i]));
+			sum += delta[i];
+			nb_covered++;
+		}
+	}
+	if (nb_covered == 0){
+		cout << "Aucun pixel commun aux deux relevés" << endl;
+		close_dem(dem,context);
+		return 0;
+	}
+	double pixel_area = context["lg_pix"]*context["h_pix"];
+	cout << "- " << nb_covered << " pixels in common, difference from " << min_delta << " to " << max_delta
+		<< " m (mean " << sum/nb_covered << " m, net volume " << sum*pixel_area << " m3)" << endl;
+
+	//indices de couleur de la colormap divergente : 0.5 pour un écart nul, extrémités à +-difference_range
+	double range = context["difference_range"];
+	if (range <= 0){
+		range = max(abs(min_delta),abs(max_delta));
+	}
+	range = max(range,1e-9);
+	int nb_colors = context["nb_colors"];
+	for(size_t i = 0; i < nb_pixels; i++){
+		if (delta[i] != dem_nodata){
+			double value = min(1.0,max(0.0,(delta[i]/range+1)/2));
+			pixels[i] = max(1,int(round(value*nb_colors))); //0 reste noir (pixel sans données)
+		}
+	}
+	close_dem(dem,context);
+
+	context["colormap"] = 1;
+	int result = generate_image(pixels,pixels_illumination,context); //(Voir generate_image.cpp)
+	if (result == 0){
+		cout << "echec d'ouverture du fichier image" << endl;
+	}
+	memory_stage("image",context);
+	return result;
+}
+
+static void prepare_survey(string file_name, survey &s){
+	/**
+	* \brief Lit, réduit si demandé (thinning) et triangule un relevé.
+	* \param file_name fichier du relevé.
+	* \param s Relevé à remplir, s.ok vaut 1 en cas de succès.
+	*/
+	if (get_projected_points(file_name,&s.points,s.context) == 0){ //(Voir init_point_pixels.cpp)
+		cout << "echec de la récupération des points de " << file_name << endl;
+		return;
+	}
+	if (s.context["thinning"] != 0){
+		thin_points(s.points,s.context); //(Voir thinning.cpp)
+	}
+	try{
+		triangulate(s.points,s.t,s.context); //(Voir triangulation.cpp)
+	}
+	catch(...){ //triangulation impossible (moins de 3 points distincts...)
+		cout << "Triangulation impossible : " << file_name << endl;
+		return;
+	}
+	index_vector().swap(s.t.halfedges); //les demi-arêtes ne servent pas à la rasterisation
+	s.ok = 1;
+}
+
+template <typename F>
+static void scan_triangles(survey &s, map<string,double> &context, F visit){
+	/**
+	* \brief Parcourt les pixels de la grille commune dont le centre est dans un triangle conservé du relevé.
+	* Seuls les triangles qui touchent la grille sont parcourus (voir build_triangle_grid et select_triangles).
+	* \param s Relevé triangulé.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la grille commune (width,height,min_x,max_x,min_y,max_y,lg_pix,h_pix).
+	* \param visit Fonction appelée avec l'indice du pixel (à partir de 0) et la profondeur du triangle au centre du pixel.
+	*/
+	int width = context["width"];
+	int height = context["height"];
+	double min_x = context["min_x"];
+	double max_y = context["max_y"];
+	double lg_pix = context["lg_pix"];
+	double h_pix = context["h_pix"];
+
+	triangle_grid grid;
+	build_triangle_grid(s.points,s.t,s.context,grid);
+	vector<size_t> selection;
+	select_triangles(grid,s.t,min_x,context["max_x"],context["min_y"],max_y,selection);
+
+	for(size_t k = 0; k < selection.size(); k++){
+		size_t i = 3*selection[k];
+		Triangle T = Triangle(s.points[s.t.triangles[i]],s.points[s.t.triangles[i+1]],s.points[s.t.triangles[i+2]]);
+
+		//pixels dont le centre peut être dans le triangle
+		int x0 = max(0,int(floor((min({T.p1.x,T.p2.x,T.p3.x})-min_x)/lg_pix)));
+		int x1 = min(width-1,int(floor((max({T.p1.x,T.p2.x,T.p3.x})-min_x)/lg_pix)));
+		int y0 = max(0,int(floor((max_y-max({T.p1.y,T.p2.y,T.p3.y}))/h_pix)));
+		int y1 = min(height-1,int(floor((max_y-min({T.p1.y,T.p2.y,T.p3.y}))/h_pix)));
+		for(int y = y0; y <= y1; y++){
+			double center_y = max_y-(y+0.5)*h_pix;
+			for(int x = x0; x <= x1; x++){
+				double center_x = min_x+(x+0.5)*lg_pix;
+				if (T.contain(center_x,center_y)){
+					visit(size_t(y)*width+x,T.compute_depth(center_x,center_y));
+				}
+			}
+		}
+	}
+}
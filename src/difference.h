@@ -0,0 +1,17 @@
+#include <string>
+#include <map> //dictionnaires
+
+#ifndef DIFFERENCE_H
+#define DIFFERENCE_H
+
+/**
+* \file difference.h
+* \brief Fichier de déclaration du mode différence : deux relevés du même site sont rendus sur une grille commune
+* (leur zone de recouvrement) et l'image montre l'écart de profondeur avec une colormap divergente.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int run_difference(std::string file_a, std::string file_b, std::map<std::string,double> &context, std::map<std::string,std::string> &paths);
+
+#endif
@@ -4,6 +4,7 @@
 #include <vector> //vecteur
 #include <map> //dictionnaires
 #include <fstream> //manipulation fichiers
+#include <sstream>
 #include <vtkSmartPointer.h> //gestion colormap
 #include <vtkColorTransferFunction.h> //gestion colormap
 #include "generate_image.h"
@@ -17,7 +18,10 @@
 
 using namespace std;
 
-int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context){
+static vtkSmartPointer<vtkColorTransferFunction> create_colormap(map<string,double> &context);
+static void color_pixel(vtkSmartPointer<vtkColorTransferFunction> &colormap, int pixel_color, double pixel_illu, int nb_colors, char *rgb);
+
+int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, string image_name){
 	/**
 	* \brief Cette fonction génère une image bianire en couleur à partir d'une liste de pixels et d'une liste de couleur. 
 	* \param pixels	Vecteur qui contient la couleur des pixels.
@@ -26,6 +30,7 @@ int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map
 	* Ici cette fonction à besoin de :
 	* - nombre de pixels voulus (width,height)
 	* - nombre de couleurs dans le color_map (nb_colors)
+	* \param image_name nom de l'image à générer.
 	*/
 
 	////////////////////
@@ -35,25 +40,6 @@ int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map
 	//récupération des variables nécessaires
 	int width = context["width"];
 	int height = context["height"];
-	int nb_colors = context["nb_colors"];
-
-	//Initialisation de la colomap :
-	// Création d'une colormap Haxby en définissant une fonction de transfert de couleur
-  	vtkSmartPointer<vtkColorTransferFunction> haxbyColorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
-
-  	//définition des points de couleurs de la colormap
-	haxbyColorMap->AddRGBPoint(1.0, 1.0, 0.5, 0.0); //map la valeur 1.0 à la couleur (1,0.5,0) = (255,127,0)RGB
-	haxbyColorMap->AddRGBPoint(0.65, 1.0, 1.0, 0.6);
-	haxbyColorMap->AddRGBPoint(0.5, 0.6, 1.0, 0.6);
-	haxbyColorMap->AddRGBPoint(0.35, 0.0, 0.9, 1.0);
-	haxbyColorMap->AddRGBPoint(0.0, 0.0, 0.1, 0.4);
-
-	//variables analytiques
-	time_t t0,tf; 
-	time(&t0);
-
-	//nom de l'image
-	string image_name = "raster.ppm";
 
 	//initialisation de l'entête de l'image
 	ofstream myImage;		//output stream object
@@ -63,11 +49,64 @@ int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map
 		cout << "Impossible de créer " << image_name << endl;
 		return 0; //arret du programme si echec
 	}
-	{ //Image header - Need this to start the image properties
-		myImage << "P6" << endl;						//Declare that you want to use binary colour values
-		myImage << width << " " << height << endl;		//Declare w & h
-		myImage << "255" << endl;						//Declare max colour ID
-	}
+	myImage << image_header(width,height);
+
+	////////////////
+	////OPERATIONS//
+	////////////////
+
+	//generation de l'image
+	vector<char> image;
+	colorize_pixels(pixels,pixels_illumination,context,image);
+
+	//enregistrement
+	myImage.write(image.data(),image.size());
+	myImage.close();
+
+	return 1;
+}
+
+string image_header(int width, int height){
+	/**
+	* \brief Renvoie l'entête d'une image binaire en couleur (ppm) de dimensions données.
+	* \param width largeur de l'image en pixels.
+	* \param height hauteur de l'image en pixels.
+	*/
+	ostringstream header;
+	header << "P6" << endl;						//Declare that you want to use binary colour values
+	header << width << " " << height << endl;		//Declare w & h
+	header << "255" << endl;						//Declare max colour ID
+	return header.str();
+}
+
+void colorize_pixels(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, vector<char> &image){
+	/**
+	* \brief Cette fonction converti les pixels en couleurs binaires {r0,g0,b0,r1,...} avec la colormap Haxby
+	* (ou divergente pour une différence de relevés) et les ombres.
+	* \param pixels	Vecteur qui contient la couleur des pixels.
+	* \param pixels_illumination Vecteur dans lequel sont stocké les illuminations des pixels (0 = non illuminé, 1 = illuminé).
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin :
+	* - nombre de pixels voulus (width,height)
+	* - nombre de couleurs dans le color_map (nb_colors)
+	* - colormap utilisée (colormap : 0 = Haxby, 1 = divergente rouge-blanc-bleu centrée sur 0.5)
+	* \param image Vecteur dans lequel stocker les couleurs des pixels.
+	*/
+
+	////////////////////
+	////INITIALISATION//
+	////////////////////
+
+	//récupération des variables nécessaires
+	int width = context["width"];
+	int height = context["height"];
+	int nb_colors = context["nb_colors"];
+
+	//Initialisation de la colomap
+	vtkSmartPointer<vtkColorTransferFunction> colormap = create_colormap(context);
+
+	//variables analytiques
+	time_t t0,tf; 
 
 	////////////////
 	////OPERATIONS//
@@ -80,36 +119,10 @@ int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map
 
 	//generation de l'image
 	cout<<endl<<"Image generation...";
+	image.resize(3*pixels.size());
 	for(int i = 0; i < pixels.size(); ++i) //on parcours la liste de pixels et leur illumination associée
 	{
-		//recupération des valeurs
-		int pixel_color = pixels[i]; //indice de couleur du pixel
-		double pixel_illu = pixels_illumination[i]; //illumination du pixel
-
-		//conversion des indices de couleur en couleurs
-		double value = double(pixel_color)/double(nb_colors); //on se ramène à une valeur entre 0 et 1
-		unsigned char* color = haxbyColorMap->MapValue(value); //conversion en couleur via la colormap définie avant
-
-		//récupération des couleurs sous forme binaire
-		char r = color[0]; //rouge
-		char g = color[1]; //vert
-		char b = color[2]; //bleu
-		
-		//ajout des ombres
-		if(pixel_illu != 1){ //si il faut assombrir le pixel...
-			DarkenColor(r,pixel_illu);
-			DarkenColor(g,pixel_illu);
-			DarkenColor(b,pixel_illu);
-		}
-
-		if (pixel_color == 0){ //on garde les pixels à 0 en noir
-			r = static_cast<char>(0); //rouge
-			g = static_cast<char>(0); //vert
-			b = static_cast<char>(0); //bleu
-		}
-
-		//enregistrement
-		myImage << r << g << b;
+		color_pixel(colormap,pixels[i],pixels_illumination[i],nb_colors,&image[3*i]);
 
 		//progression
 		compteur +=1;
@@ -121,12 +134,93 @@ int generate_image(vector<int> &pixels, vector<double> &pixels_illumination, map
 			cout << "\b";
 		}
 	}
-	myImage.close();
 
 	time(&tf);
 	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'execution
+}
+
+void colorize_band(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, char *image){
+	/**
+	* \brief Converti une bande de pixels en couleurs binaires comme colorize_pixels, sans affichage de la progression,
+	* directement dans la mémoire de destination (fichier projeté en mémoire du rendu par bandes, voir bands.cpp).
+	* \param pixels	Vecteur qui contient la couleur des pixels de la bande.
+	* \param pixels_illumination Vecteur des illuminations des pixels de la bande.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin du nombre de couleurs dans le color_map (nb_colors) et de la colormap utilisée (colormap).
+	* \param image Mémoire dans laquelle écrire les 3*pixels.size() octets des couleurs.
+	*/
+	int nb_colors = context["nb_colors"];
+	vtkSmartPointer<vtkColorTransferFunction> colormap = create_colormap(context);
+	for(size_t i = 0; i < pixels.size(); ++i){
+		color_pixel(colormap,pixels[i],pixels_illumination[i],nb_colors,image+3*i);
+	}
+}
+
+static vtkSmartPointer<vtkColorTransferFunction> create_colormap(map<string,double> &context){
+	/**
+	* \brief Crée la colormap des images.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la colormap utilisée (colormap : 0 = Haxby, 1 = divergente rouge-blanc-bleu centrée sur 0.5).
+	* \return fonction de transfert de couleur, pour des valeurs entre 0 et 1.
+	*/
+
+	// Création d'une colormap Haxby en définissant une fonction de transfert de couleur
+  	vtkSmartPointer<vtkColorTransferFunction> haxbyColorMap = vtkSmartPointer<vtkColorTransferFunction>::New();
+
+  	//définition des points de couleurs de la colormap
+	if (context["colormap"] == 1){ //différence de relevés : rouge si le fond s'est creusé, bleu s'il est remonté
+		haxbyColorMap->AddRGBPoint(0.0, 0.4, 0.0, 0.12);
+		haxbyColorMap->AddRGBPoint(0.25, 0.84, 0.38, 0.3);
+		haxbyColorMap->AddRGBPoint(0.5, 0.97, 0.97, 0.97);
+		haxbyColorMap->AddRGBPoint(0.75, 0.26, 0.58, 0.76);
+		haxbyColorMap->AddRGBPoint(1.0, 0.02, 0.19, 0.38);
+	}
+	else{
+		haxbyColorMap->AddRGBPoint(1.0, 1.0, 0.5, 0.0); //map la valeur 1.0 à la couleur (1,0.5,0) = (255,127,0)RGB
+		haxbyColorMap->AddRGBPoint(0.65, 1.0, 1.0, 0.6);
+		haxbyColorMap->AddRGBPoint(0.5, 0.6, 1.0, 0.6);
+		haxbyColorMap->AddRGBPoint(0.35, 0.0, 0.9, 1.0);
+		haxbyColorMap->AddRGBPoint(0.0, 0.0, 0.1, 0.4);
+	}
+	return haxbyColorMap;
+}
+
+static void color_pixel(vtkSmartPointer<vtkColorTransferFunction> &colormap, int pixel_color, double pixel_illu, int nb_colors, char *rgb){
+	/**
+	* \brief Converti un pixel en couleur binaire {r,g,b}, assombrie selon son illumination.
+	* \param colormap colormap à utiliser.
+	* \param pixel_color indice de couleur du pixel (0 = noir).
+	* \param pixel_illu illumination du pixel.
+	* \param nb_colors nombre de couleurs dans la colormap.
+	* \param rgb mémoire dans laquelle écrire les 3 octets de la couleur.
+	*/
+
+	//conversion des indices de couleur en couleurs
+	double value = double(pixel_color)/double(nb_colors); //on se ramène à une valeur entre 0 et 1
+	unsigned char* color = colormap->MapValue(value); //conversion en couleur via la colormap définie avant
+
+	//récupération des couleurs sous forme binaire
+	char r = color[0]; //rouge
+	char g = color[1]; //vert
+	char b = color[2]; //bleu
 	
-	return 1;
+	//ajout des ombres
+	if(pixel_illu != 1){ //si il faut assombrir le pixel...
+		DarkenColor(r,pixel_illu);
+		DarkenColor(g,pixel_illu);
+		DarkenColor(b,pixel_illu);
+	}
+
+	if (pixel_color == 0){ //on garde les pixels à 0 en noir
+		r = static_cast<char>(0); //rouge
+		g = static_cast<char>(0); //vert
+		b = static_cast<char>(0); //bleu
+	}
+
+	//enregistrement
+	rgb[0] = r;
+	rgb[1] = g;
+	rgb[2] = b;
 }
 
 void DarkenColor(char &color, double darken_percent){
@@ -14,7 +14,10 @@
 * \author NOEL Océan
 */
 
-int generate_image(std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context);
+int generate_image(std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context, std::string image_name = "raster.ppm");
+std::string image_header(int width, int height);
+void colorize_pixels(std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context, std::vector<char> &image);
+void colorize_band(std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context, char *image);
 void DarkenColor(char &color, double darken_percent);
 
 #endif
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include <map> //dictionnaires
 #include <proj.h> //projection
 #include <math.h>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "parallel.h"
+#include "text_reader.h"
 #include "struct_point.h"
 #include "init_points_pixels.h"
 
@@ -20,6 +25,24 @@
 
 using namespace std;
 
+static PJ* create_projection(PJ_CONTEXT *C);
+
+//système de coordonnées des points projetés (Lambert)
+static const char* projected_crs = "+proj=lcc +lat_1=49 +lat_2=44 +lat_0=48.199161330566646 +lon_0=-3.0146392003209987 +x_0=0 +y_0=0 +ellps=GRS80 +towgs84=0,0,0,0,0,0,0 +units=m +no_defs";
+
+void set_pixel_size(map<string,double> &context){
+	/**
+	* \brief Calcule la largeur et la hauteur en m d'un pixel (lg_pix,h_pix) et les ajoute à context.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin des valeurs limites des positions des points (min_x,min_y,max_x,max_y)
+	* et du nombre de pixels voulus (width,height).
+	*/
+	float lg_pix = (context["max_x"]-context["min_x"])/context["width"]; //largeur d'un pixel en m
+	float h_pix = (context["max_y"]-context["min_y"])/context["height"]; //hauteur d'un pixel en m
+	context["lg_pix"] = lg_pix;
+	context["h_pix"] = h_pix;
+}
+
 void create_pixels(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context){
 	/**
 	* \brief Cette fonction créer les pixels qui vont quadriller le nuage de points donner en paramètre. 
@@ -40,10 +63,6 @@ void create_pixels(vector<int> &pixels, vector<double> &pixels_illumination, map
 	//Récupération des variables nécessaires au calcul du quadrillage
 	double width = context["width"];
 	double height = context["height"];
-	double max_x = context["max_x"];
-	double min_x = context["min_x"];
-	double max_y = context["max_y"];
-	double min_y = context["min_y"];
 	double default_color = context["default_color"];
 
 	//variables analytiques
@@ -52,10 +71,7 @@ void create_pixels(vector<int> &pixels, vector<double> &pixels_illumination, map
 	int progress = 0; 
 
 	//Calcul des hauteurs et largeur des pixels, et mise à jour de la variable context
-	float lg_pix = (max_x-min_x)/width; //largeur d'un pixel en m
-	float h_pix = (max_y-min_y)/height; //hauteur d'un pixel en m
-	context["lg_pix"] = lg_pix;
-	context["h_pix"] = h_pix;
+	set_pixel_size(context);
 
 	////////////////
 	////OPERATIONS//
@@ -67,6 +83,8 @@ void create_pixels(vector<int> &pixels, vector<double> &pixels_illumination, map
 	compteur = 0;
 	progress = 0;
 
+	pixels.reserve(width*height);
+	pixels_illumination.reserve(width*height);
 	for (int i = 0; i < width*height; i++) {
 		pixels.push_back(default_color); //un pixel est représenté par un "int" qui correspond à un indice de couleur
 		pixels_illumination.push_back(1); //illumination maximale initialement pour les pixels
@@ -87,14 +105,13 @@ void create_pixels(vector<int> &pixels, vector<double> &pixels_illumination, map
 	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
 }
 
-void project_points(vector<point> *v, vector<double> &points_line, map<string,double> &context)
+void project_points(point_cloud *v, map<string,double> &context)
 {
 	/**
 	* \brief Cette fonction transforme les coordonnées géographique d'une liste de point en coordonnées planaire, 
 	* c'est une projection Lambert93. De plus elle initialise plusieurs paramètres important de "context" telle que les limites 
 	* du nuage de points.
-	* \param v Vecteur dans lequel se trouve les points en coordonnées géographique.
-	* \param points_line Vecteur dans lequel se trouve les points en coordonnées géographique sous forme {x0,y0,x1,y1...}.
+	* \param v Nuage dans lequel se trouve les points en coordonnées géographique, projetés en place.
 	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
 	* Ici cette fonction en à besoin pour initialiser certaines des valeurs.
 	*/
@@ -115,7 +132,7 @@ void project_points(vector<point> *v, vector<double> &points_line, map<string,do
 	
 	//Création de la fonction de projection
 	C = proj_context_create();
-	P = proj_create_crs_to_crs(C, "+proj=longlat +datum=WGS84","+proj=lcc +lat_1=49 +lat_2=44 +lat_0=48.199161330566646 +lon_0=-3.0146392003209987 +x_0=0 +y_0=0 +ellps=GRS80 +towgs84=0,0,0,0,0,0,0 +units=m +no_defs",NULL);
+	P = create_projection(C);
 
 	if (0 == P) {
 	    fprintf(stderr, "Failed to create transformation object.\n");
@@ -135,29 +152,26 @@ void project_points(vector<point> *v, vector<double> &points_line, map<string,do
 	double max_y = context["max_y"];
 	double min_depth = context["min_depth"];
 	double max_depth = context["max_depth"];
-	for(auto it = v->begin(); it != v->end(); ++it) //iteration sur tout les points
+	for(size_t i = 0; i < v->size(); i++) //iteration sur tout les points
 	{
-		a = proj_coord((*it).x,(*it).y, 0, 0); //coordonnée terrestres à convertir (longitude, latitude)
+		a = proj_coord(v->x(i),v->y(i), 0, 0); //coordonnée terrestres à convertir (longitude, latitude)
 		b = proj_trans(P, PJ_FWD, a); //coordonnée projetée
-		(*it).x = b.xy.x;
-		(*it).y = b.xy.y;
+		v->coords[2*i] = b.xy.x;
+		v->coords[2*i+1] = b.xy.y;
 
 		//calcul des limites du nuage de point
-		min_x = min(min_x,(*it).x);
-		max_x = max(max_x,(*it).x);
-		min_y = min(min_y,(*it).y);
-		max_y = max(max_y,(*it).y);
-		min_depth = max(min_depth,(*it).depth); //inversion min, max car profondeur négative
-		max_depth = min(max_depth,(*it).depth);
-
-		//initialisation des autres structures de stockages des points
-		double x = (*it).x;
-		double y = (*it).y;
-		points_line.push_back(x);
-		points_line.push_back(y);
-
-		//Affichage de la progression
+		min_x = min(min_x,b.xy.x);
+		max_x = max(max_x,b.xy.x);
+		min_y = min(min_y,b.xy.y);
+		max_y = max(max_y,b.xy.y);
+		min_depth = max(min_depth,v->depth[i]); //inversion min, max car profondeur négative
+		max_depth = min(max_depth,v->depth[i]);
+
+		//Affichage de la progression (seulement quand elle change, project_points est appelée à chaque lecture du mode suivi)
 		compteur +=1;
+		if (int(100*compteur/(nb_ops)) == progress){
+			continue;
+		}
 		progress = 100*compteur/(nb_ops);
 		string progress_str = to_string(progress);
 		cout << progress_str << " %";
@@ -182,12 +196,229 @@ void project_points(vector<point> *v, vector<double> &points_line, map<string,do
 
 }
 
-int get_points(string file_name, vector<point> *v)
+static PJ* create_projection(PJ_CONTEXT *C){
+	/**
+	* \brief Crée la fonction de projection des coordonnées géographiques (WGS84) en coordonnées planaires (Lambert).
+	* \param C contexte proj dans lequel créer la projection (un contexte par thread).
+	* \return fonction de projection, 0 en cas d'échec.
+	*/
+	return proj_create_crs_to_crs(C, "+proj=longlat +datum=WGS84",projected_crs,NULL);
+}
+
+string projection_wkt(){
+	/**
+	* \brief Renvoie la description WKT (variante ESRI, celle des fichiers .prj) du système de coordonnées des points projetés.
+	* \return texte WKT, vide en cas d'échec.
+	*/
+	PJ_CONTEXT *C = proj_context_create();
+	PJ *P = proj_create(C,projected_crs);
+	string wkt;
+	if (P != 0){
+		const char *text = proj_as_wkt(C,P,PJ_WKT1_ESRI,NULL);
+		if (text != NULL){
+			wkt = text;
+		}
+		proj_destroy(P);
+	}
+	proj_context_destroy(C);
+	return wkt;
+}
+
+int unproject_coords(vector<double> &coords){
+	/**
+	* \brief Convertit en place des coordonnées projetées {x0,y0,x1,y1...} en coordonnées géographiques (longitude, latitude).
+	* \param coords Coordonnées à convertir.
+	* \return 1 si la conversion a réussi, 0 sinon.
+	*/
+	PJ_CONTEXT *C = proj_context_create();
+	PJ *P = create_projection(C);
+	if (P == 0){
+		proj_context_destroy(C);
+		return 0;
+	}
+	for(size_t i = 0; i+1 < coords.size(); i+=2){
+		PJ_COORD c = proj_trans(P, PJ_INV, proj_coord(coords[i],coords[i+1], 0, 0));
+		coords[i] = c.xy.x;
+		coords[i+1] = c.xy.y;
+	}
+	proj_destroy(P);
+	proj_context_destroy(C);
+	return 1;
+}
+
+int get_projected_points(string file_name, point_cloud *v, map<string,double> &context, const function<void(vector<point>&)> &sink)
+{
+	/**
+	* \brief Lis les points d'un fichier .txt et les projette en même temps (équivalent à get_points puis project_points).
+	* Un fichier compressé en gzip (.txt.gz) est décompressé à la volée par un autre thread (voir text_reader.h).
+	* Le thread appelant lit le fichier par blocs de points qui passent par une file de taille limitée vers des threads de projection.
+	* Les blocs projetés sont ajoutés dans l'ordre du fichier et les limites du nuage de points sont calculées au fur et à mesure,
+	* ainsi les points non projetés ne sont jamais tous en mémoire en même temps que les points projetés.
+	* \param file_name nom du fichier dans lequel se trouve les données textuelles.
+	* \param v nuage dans lequel sauvegarder les points projetés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction en à besoin pour initialiser les limites du nuage de points et le nombre de points lus (nb_points),
+	* et utilise le nombre de threads (nb_threads).
+	* \param sink Si donnée, reçoit les blocs de points projetés dans l'ordre du fichier à la place de v (voir tiles.cpp).
+	* \return 1 si la lecture et la projection ont réussi, 0 sinon.
+	*/
+
+	//variables analytiques
+	time_t t0,tf; 
+	time(&t0);
+
+	cout<<"- Getting and projecting points from file...";
+	int nb_workers = max(1,int(context["nb_threads"]));
+	text_reader f(file_name,nb_workers); //tentative d'ouverture du fichier (décompressé à la volée si gzip)
+	if (!f.is_open())
+	{
+		cout << "Echec d'ouverture de " << file_name << endl;
+		return 0;
+	}
+	size_t file_size = f.size_hint();
+
+	//blocs de points lus, en attente de projection
+	struct point_block
+	{
+		size_t index = 0; //numéro du bloc dans le fichier
+		size_t bytes = 0; //taille du texte lu pour ce bloc
+		vector<point> points;
+	};
+	const size_t block_size = 16384;
+	bounded_queue<point_block> blocks(2*nb_workers);
+
+	//ajout des blocs projetés dans l'ordre du fichier
+	mutex append_mutex;
+	condition_variable append_turn;
+	size_t next_block = 0;
+	bool projection_failed = false;
+
+	//limites du nuage de points de chaque thread {min_x,max_x,min_y,max_y,min_depth,max_depth}
+	vector<vector<double>> bounds(nb_workers,{context["min_x"],context["max_x"],context["min_y"],context["max_y"],context["min_depth"],context["max_depth"]});
+
+	size_t nb_points = 0; //points ajoutés, compté aussi quand ils sont donnés à sink
+	vector<thread> workers;
+	for(int w = 0; w < nb_workers; w++){
+		workers.emplace_back([&,w](){
+			PJ_CONTEXT *C = proj_context_create(); //les objets proj ne sont pas partagés entre threads
+			PJ *P = create_projection(C);
+			if (0 == P) {
+			    fprintf(stderr, "Failed to create transformation object.\n");
+			}
+			vector<double> &b = bounds[w];
+			point_block block;
+			while(blocks.pop(block)){
+				for(point &p : block.points){
+					if (P != 0){
+						PJ_COORD c = proj_trans(P, PJ_FWD, proj_coord(p.x,p.y, 0, 0)); //coordonnée projetée
+						p.x = c.xy.x;
+						p.y = c.xy.y;
+					}
+
+					//calcul des limites du nuage de point
+					b[0] = min(b[0],p.x);
+					b[1] = max(b[1],p.x);
+					b[2] = min(b[2],p.y);
+					b[3] = max(b[3],p.y);
+					b[4] = max(b[4],p.depth); //inversion min, max car profondeur négative
+					b[5] = min(b[5],p.depth);
+				}
+
+				//ajout du bloc quand c'est son tour
+				unique_lock<mutex> lock(append_mutex);
+				append_turn.wait(lock,[&]{ return next_block == block.index; });
+				nb_points += block.points.size();
+				if (sink){
+					sink(block.points);
+				}
+				else{
+					if (block.index == 0 && block.bytes > 0){ //réservation d'après la taille moyenne d'une ligne du premier bloc
+						size_t estimate = size_t(1.02*file_size*block.points.size()/block.bytes);
+						v->reserve(estimate);
+					}
+					for(point &p : block.points){
+						v->push_back(p);
+					}
+				}
+				if (P == 0){
+					projection_failed = true;
+				}
+				next_block++;
+				append_turn.notify_all();
+			}
+			if (P != 0){
+				proj_destroy(P);
+			}
+			proj_context_destroy(C);
+		});
+	}
+
+	//lecture du fichier par blocs
+	int result = 1;
+	string str;
+	size_t line_number = 0;
+	point_block block;
+	while(f.getline(str)){
+		line_number++;
+		block.bytes += str.size()+1;
+		if (str.find_first_not_of(" \t\r") == string::npos){ //ligne vide (fin de fichier)
+			continue;
+		}
+		point p;
+		try{
+			get_point(p,str); //conversion des données textuelles en point.
+		}
+		catch(...){
+			cout << "Ligne " << line_number << " invalide dans " << file_name << endl;
+			result = 0;
+			break;
+		}
+		block.points.push_back(p);
+		if (block.points.size() == block_size){
+			size_t index = block.index;
+			blocks.push(move(block));
+			block = point_block();
+			block.index = index+1;
+		}
+	}
+	if (!block.points.empty() && result == 1){
+		blocks.push(move(block));
+	}
+	blocks.close();
+	for(auto &worker : workers){
+		worker.join();
+	}
+	if (f.failed()){
+		cout << "Fichier " << file_name << " tronqué ou corrompu" << endl;
+		result = 0;
+	}
+	if (projection_failed){
+		result = 0;
+	}
+
+	//réduction des limites des threads
+	for(vector<double> &b : bounds){
+		context["min_x"] = min(context["min_x"],b[0]);
+		context["max_x"] = max(context["max_x"],b[1]);
+		context["min_y"] = min(context["min_y"],b[2]);
+		context["max_y"] = max(context["max_y"],b[3]);
+		context["min_depth"] = max(context["min_depth"],b[4]); //inversion min, max car profondeur négative
+		context["max_depth"] = min(context["max_depth"],b[5]);
+	}
+	context["nb_points"] = nb_points;
+
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+
+	return result;
+}
+
+int get_points(string file_name, point_cloud *v)
 {
 	/**
-	* \brief Lis une liste de données de points au format .txt et les stock sous forme de vecteur de point.
+	* \brief Lis une liste de données de points au format .txt et les stock dans un nuage de points.
 	* \param file_name nom du fichier dans lequel se trouve les données textuelles.
-	* \param v vecteur dans lequel sauvegarder les points récupérés.
+	* \param v nuage dans lequel sauvegarder les points récupérés.
 	*/
 
 	//variables analytiques
@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include <vector> //vecteur
 #include <map> //dictionnaires
+#include <functional>
 #include "struct_point.h"
 
 #ifndef INIT_POINT_PIXEL_H
@@ -16,9 +17,13 @@
 * \author NOEL Océan
 */
 
+void set_pixel_size(std::map<std::string,double> &context);
 void create_pixels(std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context);
 void get_point(point& p,std::string& str);
-int get_points(std::string file_name,std::vector<point> *v);
-void project_points(std::vector<point> *v, std::vector<double> &points_line, std::map<std::string,double> &context);
+int get_points(std::string file_name,point_cloud *v);
+void project_points(point_cloud *v, std::map<std::string,double> &context);
+std::string projection_wkt();
+int unproject_coords(std::vector<double> &coords);
+int get_projected_points(std::string file_name, point_cloud *v, std::map<std::string,double> &context, const std::function<void(std::vector<point>&)> &sink = nullptr);
 
 #endif
\ No newline at end of file
@@ -6,13 +6,31 @@
 #include <ctime> //temps, mesures d'executions
 #include <vector> //vecteur
 #include <map> //dictionnaires
+#include <sstream>
 #include "triangulation.h" //fonctions pour triangulation
 #include "struct_point.h" //définissions de la structure d'un points
 #include "init_points_pixels.h" //fonctions pour initialisation des poinst et pixels
 #include "generate_image.h" 
+#include "shading.h" //ombrage lisse multi-directionnel et ombres portées
+#include "parallel.h" //nombre de threads par défaut
+#include "server.h" //mode serveur
+#include "batch.h" //mode batch
+#include "thinning.h" //réduction du nombre de points
+#include "binning.h" //rendu par accumulation des points dans les pixels
+#include "dem.h" //modèle numérique de terrain
+#include "memory.h" //suivi de la mémoire
+#include "difference.h" //différence de deux relevés
+#include "contours.h" //isobathes
+#include "bands.h" //rendu par bandes
+#include "tin_cache.h" //cache des triangulations
+#include "tiles.h" //rendu distribué par tuiles
+#include "watch.h" //suivi d'un relevé en cours d'acquisition
+#include "mosaic.h" //mosaïque de plusieurs relevés
 
 using namespace std;  
 
+int read_options(int argc, char *argv[], int first, map<string,double> &context, map<string,string> &paths);
+
 /**
 * \file main.cpp
 * \brief Fichier principale qui organise et lance les différentes fonctions. 
@@ -34,16 +52,14 @@ int main(int argc, char *argv[])
 
 	//initialisation des variables
 	map<string,double> context; //variable qui permet de stocker des paramètre important du programme (évite les variables globales)
-	vector<point> points;  //stocke les points de relevés de mesures
-	vector<double> points_line;  //stocke les points sous forme {x0,y0,x1,y1} (utilisé lors de la triangulation)
+	point_cloud points;  //stocke les points de relevés de mesures (coordonnées {x0,y0,x1,y1...} utilisées par la triangulation, et profondeurs)
 	vector<int> pixels; //stock la valeure des pixels sous forme {pixel1,pixel2,...}
 	vector<double> pixels_illumination; //stock la valeure de l'illumination des pixels sous forme {ombre_pixel1,ombre_pixel2,...} (0 = non illuminé, 1 = illuminé au maximum)
 	string file_name; //nom du fichier à ouvrir pour les valeurs 
+	map<string,string> paths; //chemins donnés en options (socket du mode serveur...)
 	int image_size; //largeur en pixel de l'image à générer
-	vector<double> sun_dir = {-1,0,0}; //direction de la lumière du soleil
-	context["sun_dir_x"] = sun_dir[0];
-	context["sun_dir_y"] = sun_dir[1];
-	context["sun_dir_z"] = sun_dir[2];
+	context["sun_azimuth"] = 90; //azimut en degrés du soleil (à l'est par défaut)
+	context["sun_elevation"] = 0; //élévation en degrés du soleil (sur l'horizon par défaut)
 	context["default_color"] = 0; //couleur par défaut des pixels
 	context["nb_colors"] = 100000; //nombre de couleurs dans la colormap possibles pour les pixels (échantillonage)
 	context["max_x"] = -99999999; //initialisée dans "project_points()"  : ordonnées x maximale des points
@@ -52,18 +68,110 @@ int main(int argc, char *argv[])
 	context["min_y"] = 99999999; //initialisée dans "project_points()"  : ordonnées y minimale des points
 	context["min_depth"] = -99999999; //initialisée dans "project_points()"  : profondeur minimale des points
 	context["max_depth"] = 99999999; //initialisée dans "project_points()"  : profondeure maximale des points
+	context["nb_points"] = 0; //initialisée dans "get_projected_points()" : nombre de points lus (avant réduction)
 	context["lg_pix"] = 0; //initialisée dans "create_pixels()"  : longeur d'un pixel en m
 	context["h_pix"] = 0; //initialisée dans "create_pixels()"  : hauteur d'un pixel en m
+	context["shading"] = 0; //mode d'ombrage : 0 = un ombrage par triangle (sun_dir), 1 = ombrage lisse multi-directionnel
+	context["light_elevation"] = 45; //élévation en degrés des lumières de l'ombrage lisse
+	read_lights("225,270,315,360",context); //azimuts en degrés des lumières de l'ombrage lisse
+	context["nb_threads"] = default_nb_threads(); //nombre de threads pour les calculs parallèles
+	context["shadows"] = 0; //calcul des ombres portées : 0 = non, 1 = oui
+	context["shadow_factor"] = 0.6; //illumination multipliée par ce facteur dans les ombres portées
+	context["thinning"] = 0; //réduction des points avant triangulation : 0 = aucune, 1 = min, 2 = max, 3 = moyenne, 4 = médiane par case
+	context["thinning_tolerance"] = 1; //taille des cases de la réduction en pixels (0 = doublons exacts uniquement)
+	context["overlap"] = 0; //règle des recouvrements d'une mosaïque de relevés : 0 = le plus récent, 1 = le moins profond, 2 = moyenne par case
+	context["overlap_cell"] = 1; //taille en pixels des cases dans lesquelles les recouvrements sont résolus
+	context["thinning_cell"] = 0; //initialisée dans "thin_points()" : taille des cases de la réduction en m
+	context["engine"] = 0; //moteur de rendu : 0 = auto, 1 = triangulation, 2 = accumulation des points dans les pixels
+	context["binning"] = 0; //profondeur d'un pixel en accumulation : 0 = moyenne, 1 = min, 2 = max
+	context["binning_threshold"] = 4; //nombre de points par pixel à partir duquel l'accumulation est choisie en mode auto
+	context["lod"] = 0; //niveaux de détail de la triangulation selon la taille des pixels : 0 = non, 1 = oui
+	context["lod_error"] = 0; //écart vertical maximal en m du premier niveau de détail (0 = 1/256 de l'écart de profondeur)
+	context["mesh_quantization"] = 0; //nombre de bits par axe des sommets du maillage exporté (0 = float)
+	context["colormap"] = 0; //colormap de l'image : 0 = Haxby (profondeurs), 1 = divergente (différence de relevés)
+	context["difference_range"] = 0; //écart en m des extrémités de la colormap du mode différence (0 = plus grand écart)
+	context["nb_contour_levels"] = 0; //nombre de profondeurs d'isobathes données (contour_level_i)
+	context["contour_interval"] = 0; //intervalle en profondeur des isobathes si aucune liste n'est donnée (0 = aucune)
+	context["contour_geographic"] = 0; //coordonnées des isobathes : 0 = projetées en m, 1 = longitude, latitude
+	context["band_rows"] = 0; //lignes par bande du rendu par bandes, écrites pendant le rendu des suivantes (0 = image entière)
+	context["sparse_tile"] = 0; //taille en pixels des tuiles du rendu creux, seules les tuiles touchées par des triangles sont rendues (0 = image entière)
+	context["progressive"] = 0; //nombre d'aperçus du rendu progressif, le premier de largeur width/2^progressive (0 = aucun)
+	context["tiles"] = 0; //nombre de tuiles par coté du rendu distribué, chacune rendue par un autre processus (0 = pas de tuiles)
+	context["tile_halo"] = 16; //marge minimale en pixels autour d'une tuile dont les points sont triangulés avec ceux de la tuile (voir run_tiles)
+	context["tile_workers"] = 0; //nombre de processus travailleurs simultanés du rendu par tuiles (0 = nombre de threads)
+	context["tile_stage"] = 0; //étape d'un travailleur du rendu par tuiles : 1 = triangulation, 2 = rendu
+	context["lim_triangle_lg"] = 0; //longueur maximale d'un coté de triangle donnée par le coordinateur à l'étape 2 d'un travailleur
+	context["watch"] = 0; //intervalle en s entre deux lectures du fichier suivi, seules les tuiles modifiées sont recalculées (0 = pas de suivi)
+	context["watch_timeout"] = 0; //durée en s sans nouvelles données après laquelle le suivi s'arrête (0 = jamais)
+	context["memory_report"] = 0; //rapport de la mémoire à la fin de chaque étape : 0 = non, 1 = oui
+	context["memory_budget"] = sysconf(_SC_PHYS_PAGES)/2*(sysconf(_SC_PAGE_SIZE)/1024.0)/1024; //mémoire en Mo des travaux en cours du mode batch (moitié de la RAM)
+
+	//mode batch : "--batch manifeste" remplace le fichier et la largeur
+	if (argc>=3 && string(argv[1]) == "--batch" && read_options(argc,argv,1,context,paths)){
+		set_sun_dir(context);
+		set_tin_cache(paths["tin_cache"]); //(Voir tin_cache.cpp)
+		int nb_failed = run_batch(paths["batch"],context); //(Voir batch.cpp)
+		return (nb_failed == 0) ? 0 : 1;
+	}
+
+	//travailleur du rendu par tuiles : "--worker fichier_de_tuile" remplace le fichier et la largeur
+	if (argc>=3 && string(argv[1]) == "--worker" && read_options(argc,argv,1,context,paths)){
+		set_sun_dir(context);
+		return run_tile_worker(paths["worker"],context); //(Voir tiles.cpp)
+	}
 
 	//lecture et initialisation des arguments
-	if (argc==3){
+	if (argc>=3 && read_options(argc,argv,3,context,paths)){
 		file_name = argv[1];
 		image_size = stod(argv[2]);
+		set_sun_dir(context); //direction de la lumière du soleil (sun_dir_x,sun_dir_y,sun_dir_z), {-1,0,0} par défaut
+		set_tin_cache(paths["tin_cache"]); //cache des triangulations (Voir tin_cache.cpp)
 	}
 	else{
-		cout << "Arguments incorrects, il faut (uniquement) : "<<endl;
+		cout << "Arguments incorrects, il faut : "<<endl;
 		cout << "- le chemin/nom du fichier de donnees"<<endl;
 		cout << "- la largeur de l’image generee, en pixels" <<endl;
+		cout << "Options possibles ensuite :"<<endl;
+		cout << "--shading flat|smooth : ombrage par triangle ou lisse multi-directionnel"<<endl;
+		cout << "--lights az1,az2,... : azimuts en degres des lumieres (ou az1:poids1,...)"<<endl;
+		cout << "--light_elevation e : elevation en degres des lumieres"<<endl;
+		cout << "--threads n : nombre de threads"<<endl;
+		cout << "--sun_azimuth a, --sun_elevation e : position en degres du soleil"<<endl;
+		cout << "--shadows on|off : calcul des ombres portees"<<endl;
+		cout << "--shadow_factor f : assombrissement des ombres portees (entre 0 et 1)"<<endl;
+		cout << "--thinning none|min|max|mean|median : un point par case avant triangulation"<<endl;
+		cout << "--thinning_tolerance t : taille des cases en pixels (0 = doublons exacts uniquement)"<<endl;
+		cout << "--overlap newest|shoalest|mean : resolution des recouvrements d'une mosaique (fichiers separes par des virgules)"<<endl;
+		cout << "--overlap_cell p : taille en pixels des cases des recouvrements"<<endl;
+		cout << "--engine auto|tin|binning : triangulation ou accumulation des points dans les pixels (auto selon les points par pixel)"<<endl;
+		cout << "--binning mean|min|max : profondeur d'un pixel en accumulation"<<endl;
+		cout << "--binning_threshold n : points par pixel a partir desquels l'accumulation est choisie"<<endl;
+		cout << "--lod on|off : triangulation simplifiee adaptee a la taille des pixels"<<endl;
+		cout << "--lod_error e : ecart vertical maximal en m du premier niveau de detail"<<endl;
+		cout << "--dem fichier.bil : profondeurs des pixels en float32 (georeferencement dans le .hdr et le .prj)"<<endl;
+		cout << "--slope, --aspect, --rugosity fichier.bil : pente, orientation et rugosite des pixels en float32"<<endl;
+		cout << "--mesh fichier.ply|.stl|.glb : export de la triangulation en maillage 3D binaire"<<endl;
+		cout << "--mesh_quantization bits : sommets du maillage quantifies sur 1 a 16 bits par axe (0 = float)"<<endl;
+		cout << "--contours fichier.geojson|.wkt : isobathes calculees sur la triangulation"<<endl;
+		cout << "--contour_levels p1,p2,... ou --contour_interval i : profondeurs des isobathes"<<endl;
+		cout << "--contour_crs projected|geographic : coordonnees des isobathes en m ou en longitude, latitude"<<endl;
+		cout << "--difference releve2 : ecart de profondeur (releve2 - releve) sur la zone commune, colormap divergente"<<endl;
+		cout << "--difference_range m : ecart en m des extremites de la colormap (0 = plus grand ecart)"<<endl;
+		cout << "--band_rows n : rendu par bandes de n lignes, ecrites dans l'image pendant le rendu des suivantes"<<endl;
+		cout << "--sparse_tile p : rendu par tuiles de p pixels, seules les tuiles touchees par des triangles sont allouees et ecrites"<<endl;
+		cout << "--tin_cache dossier : triangulations enregistrees et relues pour les rendus suivants des memes points"<<endl;
+		cout << "--progressive n : n apercus de plus en plus fins (le premier a 1/2^n de la largeur) ecrits avant l'image"<<endl;
+		cout << "--tiles n : rendu par n x n tuiles, chacune triangulee et rendue par un autre processus puis assemblees"<<endl;
+		cout << "--tile_halo p : marge minimale en pixels des points ajoutes autour de chaque tuile"<<endl;
+		cout << "--tile_workers n : nombre de processus travailleurs simultanes (par defaut le nombre de threads)"<<endl;
+		cout << "--tile_dir dossier : dossier des fichiers echanges avec les travailleurs (partage entre les machines)"<<endl;
+		cout << "--tile_launcher commande : commande qui lance chaque travailleur (ex. ssh), TILE_INDEX donne sa tuile"<<endl;
+		cout << "--watch s : suivi du fichier toutes les s secondes, seules les tuiles touchees par les nouveaux triangles sont reecrites"<<endl;
+		cout << "--watch_timeout s : fin du suivi apres s secondes sans nouvelles donnees (0 = jamais)"<<endl;
+		cout << "--memory_report on|off : memoire du processus et des principales structures a la fin de chaque etape"<<endl;
+		cout << "--server socket : mode serveur, les rendus sont demandes en JSON sur la socket Unix"<<endl;
+		cout << "Ou bien, pour traiter plusieurs releves : --batch manifeste [options]"<<endl;
+		cout << "(une ligne 'fichier largeur image' par releve dans le manifeste, --memory_budget Mo pour limiter la memoire)"<<endl;
 		return 0;
 	}
 	context["width"] = image_size; //largeur de l'image en pixels
@@ -71,23 +179,68 @@ int main(int argc, char *argv[])
 
 	cout <<endl<< "Starting program with arguments : [" <<file_name<<","<<image_size<<"]"<<endl;
 
+	//rendu distribué : les tuiles sont triangulées et rendues par des processus travailleurs (voir tiles.cpp)
+	if (context["tiles"] > 0){
+		vector<string> options(argv+3,argv+argc);
+		int result = run_tiles("../assets/"+file_name,context,paths,options); //(Voir tiles.cpp)
+		time(&tf);
+		cout<<endl<<"Temps total d'execution : ("<<tf-t0<<" s)"<<endl<<endl; //affichage du temps d'éxecution
+		return (result == 1) ? 0 : 1;
+	}
+
+	//mode suivi : le fichier grandit pendant l'acquisition, l'image est mise à jour tuile par tuile (voir watch.cpp)
+	if (context["watch"] > 0){
+		int result = run_watch("../assets/"+file_name,context); //(Voir watch.cpp)
+		return (result == 1) ? 0 : 1;
+	}
+
+	//mode différence : écart de profondeur entre deux relevés sur leur zone commune
+	if (paths.count("difference")){
+		int result = run_difference("../assets/"+file_name,"../assets/"+paths["difference"],context,paths); //(Voir difference.cpp)
+		memory_report(context);
+		return (result == 1) ? 0 : 1;
+	}
+
 	/////////////////////////////////
 	/////ACQUISITION ET ANALYSE//////
 	/////////////////////////////////
 
-	//création et récupération des points en coordonnées géographiques
+	//récupération des points et projection au fil de la lecture, calculs de plusieurs paramètres du nuage de points
 	cout <<endl<< "Data initialisation :" <<endl;
-	int result = get_points("../assets/"+file_name,&points); //Voir init_point_pixels.cpp)
+	int result = 0;
+	if (file_name.find(',') == string::npos){
+		result = get_projected_points("../assets/"+file_name,&points,context); //Voir init_point_pixels.cpp)
+	}
+	else{
+		//mosaïque : plusieurs relevés séparés par des virgules, du plus ancien au plus récent
+		vector<string> file_names;
+		stringstream names(file_name);
+		string name;
+		while (getline(names,name,',')){
+			file_names.push_back("../assets/"+name);
+		}
+		result = get_mosaic_points(file_names,&points,context); //(Voir mosaic.cpp)
+	}
 	if(result == 0){
 		cout << "echec de la récupération des points" << endl;
 		return 0;
 	}
+	memory_stage("reading",context); //(Voir memory.cpp)
 
-	//projection des points et calculs de plusieurs paramètres du nuage de points
-	project_points(&points,points_line,context); //(Voir init_point_pixels.cpp)
+	//réduction du nombre de points, une valeur par case de la grille
+	if (context["thinning"] != 0){
+		thin_points(points,context); //(Voir thinning.cpp)
+		memory_stage("thinning",context);
+	}
 
-	//Création et intialisation des pixels 
-	create_pixels(pixels,pixels_illumination,context); //(Voir init_point_pixels.cpp)
+	//mode serveur : la triangulation reste en mémoire et les rendus sont faits à la demande
+	if (paths.count("server")){
+		run_server(paths["server"],points,context); //(Voir server.cpp)
+		return 0;
+	}
+
+	//taille des pixels, les pixels sont créés juste avant la coloration (pas en même temps que delaunator)
+	set_pixel_size(context); //(Voir init_point_pixels.cpp)
 
 	/*cout << "Context : "<< context["default_color"] << " , "<<
 	context["nb_colors"]  << " , "<<
@@ -104,22 +257,260 @@ int main(int argc, char *argv[])
 	/////CALCULS//////
 	//////////////////
 	
+	//modèle numérique de terrain et canaux dérivés des triangles, remplis en place par le rendu en un seul parcours
+	string channel_options[4] = {"dem","slope","aspect","rugosity"};
+	dem_raster rasters[4];
+	pixel_channels channels;
+	float** channel_data[4] = {&channels.depth,&channels.slope,&channels.aspect,&channels.rugosity};
+	for(int k = 0; k < 4; k++){
+		if (paths[channel_options[k]] != ""){
+			if (!create_dem(paths[channel_options[k]],context,rasters[k])){ //(Voir dem.cpp)
+				return 0;
+			}
+			*channel_data[k] = rasters[k].data;
+		}
+	}
+	bool surface_channels = channels.slope != nullptr || channels.aspect != nullptr || channels.rugosity != nullptr;
+
 	//Triangulation et coloration
-	triangulate_n_color(points,points_line,pixels,pixels_illumination,context); //(Voir triangulation.cpp)
+	if (paths["mesh"] == "" && paths["contours"] == "" && !surface_channels && use_binning(points,context)){ //plusieurs points par pixel : accumulation directe (Voir binning.cpp)
+		create_pixels(pixels,pixels_illumination,context); //Création et intialisation des pixels (Voir init_point_pixels.cpp)
+		bin_n_color(points,pixels,pixels_illumination,context,&channels);
+	}
+	else{ //l'export du maillage, les isobathes et les canaux dérivés des triangles demandent la triangulation
+		string band_image = (context["band_rows"] > 0 || context["sparse_tile"] > 0) ? "raster.ppm" : ""; //image écrite par bandes ou tuiles creuses (Voir bands.cpp, sparse.cpp)
+		string preview_image = (context["progressive"] > 0) ? "raster.ppm" : ""; //aperçus du rendu progressif (Voir progressive.cpp)
+		triangulate_n_color(points,pixels,pixels_illumination,context,paths["mesh"],&channels,paths["contours"],band_image,preview_image); //(Voir triangulation.cpp)
+	}
+	for(int k = 0; k < 4; k++){
+		close_dem(rasters[k],context);
+	}
+	points.clear(); //les points ne servent plus, libérés avant la création de l'image
+	memory_stage("coloration",context);
 
 	////////////////////
 	/////AFFICHAGE//////
 	////////////////////
 
-	result = generate_image(pixels,pixels_illumination,context); //generation de l'image binaire colorée
-	if (result == 0){
-		cout << "echec d'ouverture du fichier image" << endl;
-		return 0;
+	if (!pixels.empty()){ //image pas déjà écrite par bandes pendant le rendu
+		result = generate_image(pixels,pixels_illumination,context); //generation de l'image binaire colorée
+		if (result == 0){
+			cout << "echec d'ouverture du fichier image" << endl;
+			return 0;
+		}
+		memory_stage("image",context);
 	}
+	memory_report(context);
 
 	cout<<endl<<"END"<<endl;
 
 	time(&tf);
 	cout<<endl<<"Temps total d'execution : ("<<tf-t0<<" s)"<<endl<<endl; //affichage du temps d'éxecution
 
-}
\ No newline at end of file
+}
+
+int read_options(int argc, char *argv[], int first, map<string,double> &context, map<string,string> &paths){
+	/**
+	* \brief Lis les options facultatives données après les deux arguments obligatoires, sous la forme "--nom valeur".
+	* \param argc nombre d'arguments.
+	* \param argv arguments du programme.
+	* \param first indice de la première option.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param paths Dictionnaire des chemins donnés en options.
+	* \return 1 si les options sont valides, 0 sinon.
+	*/
+	for(int i = first; i < argc; i+=2){
+		if (i+1 >= argc){ //option sans valeur
+			return 0;
+		}
+		string name = argv[i];
+		string value = argv[i+1];
+		try{
+			if (name == "--shading"){
+				if (value == "flat"){
+					context["shading"] = 0;
+				}
+				else if (value == "smooth"){
+					context["shading"] = 1;
+				}
+				else{
+					return 0;
+				}
+			}
+			else if (name == "--lights"){
+				if (read_lights(value,context) == 0){
+					return 0;
+				}
+			}
+			else if (name == "--light_elevation"){
+				context["light_elevation"] = stod(value);
+			}
+			else if (name == "--threads"){
+				context["nb_threads"] = max(1,stoi(value));
+			}
+			else if (name == "--sun_azimuth"){
+				context["sun_azimuth"] = stod(value);
+			}
+			else if (name == "--sun_elevation"){
+				context["sun_elevation"] = stod(value);
+			}
+			else if (name == "--shadows"){
+				if (value == "on"){
+					context["shadows"] = 1;
+				}
+				else if (value == "off"){
+					context["shadows"] = 0;
+				}
+				else{
+					return 0;
+				}
+			}
+			else if (name == "--shadow_factor"){
+				context["shadow_factor"] = min(1.0,max(0.0,stod(value)));
+			}
+			else if (name == "--thinning"){
+				if (!read_thinning(value,context)){
+					return 0;
+				}
+			}
+			else if (name == "--thinning_tolerance"){
+				context["thinning_tolerance"] = max(0.0,stod(value));
+			}
+			else if (name == "--overlap"){
+				if (!read_overlap(value,context)){
+					return 0;
+				}
+			}
+			else if (name == "--overlap_cell"){
+				context["overlap_cell"] = max(0.0,stod(value));
+			}
+			else if (name == "--engine"){
+				if (!read_engine(value,context)){
+					return 0;
+				}
+			}
+			else if (name == "--binning"){
+				if (!read_binning(value,context)){
+					return 0;
+				}
+			}
+			else if (name == "--binning_threshold"){
+				context["binning_threshold"] = max(0.0,stod(value));
+			}
+			else if (name == "--lod"){
+				if (value == "on"){
+					context["lod"] = 1;
+				}
+				else if (value == "off"){
+					context["lod"] = 0;
+				}
+				else{
+					return 0;
+				}
+			}
+			else if (name == "--lod_error"){
+				context["lod_error"] = max(0.0,stod(value));
+			}
+			else if (name == "--dem" || name == "--slope" || name == "--aspect" || name == "--rugosity"){
+				paths[name.substr(2)] = value;
+			}
+			else if (name == "--mesh"){
+				paths["mesh"] = value;
+			}
+			else if (name == "--mesh_quantization"){
+				context["mesh_quantization"] = min(16,max(0,stoi(value)));
+			}
+			else if (name == "--server"){
+				paths["server"] = value;
+			}
+			else if (name == "--batch"){
+				paths["batch"] = value;
+			}
+			else if (name == "--contours"){
+				paths["contours"] = value;
+			}
+			else if (name == "--contour_levels"){
+				if (!read_contour_levels(value,context)){ //(Voir contours.cpp)
+					return 0;
+				}
+			}
+			else if (name == "--contour_interval"){
+				context["contour_interval"] = max(0.0,stod(value));
+			}
+			else if (name == "--contour_crs"){
+				if (value == "projected"){
+					context["contour_geographic"] = 0;
+				}
+				else if (value == "geographic"){
+					context["contour_geographic"] = 1;
+				}
+				else{
+					return 0;
+				}
+			}
+			else if (name == "--difference"){
+				paths["difference"] = value;
+			}
+			else if (name == "--difference_range"){
+				context["difference_range"] = max(0.0,stod(value));
+			}
+			else if (name == "--tin_cache"){
+				paths["tin_cache"] = value;
+			}
+			else if (name == "--progressive"){
+				context["progressive"] = min(12,max(0,stoi(value)));
+			}
+			else if (name == "--band_rows"){
+				context["band_rows"] = max(0,stoi(value));
+			}
+			else if (name == "--sparse_tile"){
+				context["sparse_tile"] = max(0,stoi(value));
+			}
+			else if (name == "--tiles"){
+				context["tiles"] = min(16,max(0,stoi(value)));
+			}
+			else if (name == "--tile_halo"){
+				context["tile_halo"] = max(0.0,stod(value));
+			}
+			else if (name == "--tile_workers"){
+				context["tile_workers"] = max(0,stoi(value));
+			}
+			else if (name == "--tile_dir" || name == "--tile_launcher" || name == "--worker"){
+				paths[name.substr(2)] = value;
+			}
+			else if (name == "--tile_stage"){
+				context["tile_stage"] = min(2,max(1,stoi(value)));
+			}
+			else if (name == "--lim_triangle_lg"){
+				context["lim_triangle_lg"] = max(0.0,stod(value));
+			}
+			else if (name == "--watch"){
+				context["watch"] = max(0.0,stod(value));
+			}
+			else if (name == "--watch_timeout"){
+				context["watch_timeout"] = max(0.0,stod(value));
+			}
+			else if (name == "--memory_report"){
+				if (value == "on"){
+					context["memory_report"] = 1;
+				}
+				else if (value == "off"){
+					context["memory_report"] = 0;
+				}
+				else{
+					return 0;
+				}
+			}
+			else if (name == "--memory_budget"){
+				context["memory_budget"] = max(1.0,stod(value));
+			}
+			else{
+				return 0;
+			}
+		}
+		catch(...){ //valeur non numérique
+			return 0;
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,128 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <iomanip>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "memory.h"
+
+/**
+* \file memory.cpp
+* \brief Fichier d'implémentation du suivi de la mémoire.
+* Les octets des principales structures (nuage de points, triangulation) sont comptés par leur allocateur,
+* la mémoire du processus (RSS) est lue dans /proc/self à chaque fin d'étape.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+memory_counter memory_counters[nb_memory_categories];
+
+struct memory_record
+{
+	/**
+	* \brief Mémoire mesurée à la fin d'une étape.
+	* \param name nom de l'étape.
+	* \param rss mémoire du processus à la fin de l'étape en octets.
+	* \param peak_rss pic de mémoire du processus pendant l'étape en octets.
+	* \param retained octets de chaque catégorie encore alloués à la fin de l'étape.
+	* \param peak pic des octets de chaque catégorie pendant l'étape.
+	*/
+	string name;
+	size_t rss, peak_rss;
+	size_t retained[nb_memory_categories];
+	size_t peak[nb_memory_categories];
+};
+
+static vector<memory_record> records;
+static const char* category_names[nb_memory_categories] = {"points","triangulation"};
+
+static size_t status_value(string key);
+static void reset_peak_rss();
+
+size_t memory_rss(){
+	/**
+	* \brief Renvoie la mémoire physique utilisée par le processus.
+	* \return Mémoire résidente (RSS) en octets, 0 si /proc n'est pas disponible.
+	*/
+	return status_value("VmRSS:");
+}
+
+void memory_stage(string name, map<string,double> &context){
+	/**
+	* \brief Enregistre la mémoire à la fin d'une étape puis remet les pics à zéro pour l'étape suivante.
+	* \param name nom de l'étape terminée.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction ne fait rien si memory_report ne vaut pas 1.
+	*/
+	if (context["memory_report"] != 1){
+		return;
+	}
+	memory_record r;
+	r.name = name;
+	r.rss = memory_rss();
+	r.peak_rss = status_value("VmHWM:");
+	for(int c = 0; c < nb_memory_categories; c++){
+		r.retained[c] = memory_counters[c].current.load();
+		r.peak[c] = memory_counters[c].peak.exchange(r.retained[c]);
+	}
+	records.push_back(r);
+	reset_peak_rss();
+}
+
+void memory_report(map<string,double> &context){
+	/**
+	* \brief Affiche la mémoire enregistrée à la fin de chaque étape (voir memory_stage) :
+	* mémoire du processus et octets comptés de chaque catégorie, conservés et au maximum pendant l'étape.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction ne fait rien si memory_report ne vaut pas 1.
+	*/
+	if (context["memory_report"] != 1){
+		return;
+	}
+	const double mo = 1024.0*1024.0;
+	cout << endl << "Memory report (Mo, retained / peak of the stage) :" << endl;
+	cout << fixed << setprecision(1);
+	for(size_t i = 0; i < records.size(); i++){
+		memory_record &r = records[i];
+		cout << "- " << left << setw(16) << r.name << right << " rss " << setw(8) << r.rss/mo << " / " << setw(8) << r.peak_rss/mo;
+		for(int c = 0; c < nb_memory_categories; c++){
+			cout << ", " << category_names[c] << " " << setw(8) << r.retained[c]/mo << " / " << setw(8) << r.peak[c]/mo;
+		}
+		cout << endl;
+	}
+	cout.unsetf(ios::floatfield);
+	cout << setprecision(6);
+	records.clear();
+}
+
+static size_t status_value(string key){
+	/**
+	* \brief Lit une valeur en kB de /proc/self/status.
+	* \param key nom de la valeur avec ses deux points (VmRSS:, VmHWM:...).
+	* \return Valeur en octets, 0 si elle n'est pas trouvée.
+	*/
+	ifstream status("/proc/self/status");
+	string name;
+	size_t value;
+	while(status >> name){
+		if (name == key && status >> value){
+			return value*1024;
+		}
+		status.ignore(256,'\n');
+	}
+	return 0;
+}
+
+static void reset_peak_rss(){
+	/**
+	* \brief Remet le pic de mémoire du processus (VmHWM) à la mémoire actuelle, pour mesurer le pic de l'étape suivante.
+	* Sans droit d'écriture sur /proc/self/clear_refs, les pics sont mesurés depuis le début du programme.
+	*/
+	ofstream clear_refs("/proc/self/clear_refs");
+	if (clear_refs){
+		clear_refs << "5";
+	}
+}
@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <string>
+#include <atomic>
+#include <memory> //allocateur standard
+#include <vector> //vecteur
+#include <map> //dictionnaires
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+/**
+* \file memory.h
+* \brief Fichier de déclaration du suivi de la mémoire : allocateur qui compte les octets des principales structures
+* et rapport de la mémoire (RSS, pics) à chaque étape du programme.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+//structures dont la mémoire est comptée
+enum memory_category {memory_points, memory_triangulation, nb_memory_categories};
+
+struct memory_counter
+{
+	/**
+	* \brief Octets alloués par une catégorie de structures.
+	* \param current octets actuellement alloués.
+	* \param peak maximum de current depuis le début de l'étape en cours.
+	*/
+	std::atomic<std::size_t> current{0};
+	std::atomic<std::size_t> peak{0};
+
+	void add(std::size_t bytes){
+		std::size_t now = current.fetch_add(bytes)+bytes;
+		std::size_t previous = peak.load();
+		while(now > previous && !peak.compare_exchange_weak(previous,now)){}
+	}
+	void remove(std::size_t bytes){
+		current.fetch_sub(bytes);
+	}
+};
+
+extern memory_counter memory_counters[nb_memory_categories];
+
+template <typename T, int category>
+struct counting_allocator
+{
+	/**
+	* \brief Allocateur standard qui ajoute la taille de chaque allocation au compteur de sa catégorie.
+	*/
+	typedef T value_type;
+	template <typename U> struct rebind { typedef counting_allocator<U,category> other; };
+
+	counting_allocator() = default;
+	template <typename U> counting_allocator(const counting_allocator<U,category>&) {}
+
+	T* allocate(std::size_t n){
+		T* p = std::allocator<T>().allocate(n);
+		memory_counters[category].add(n*sizeof(T));
+		return p;
+	}
+	void deallocate(T* p, std::size_t n){
+		memory_counters[category].remove(n*sizeof(T));
+		std::allocator<T>().deallocate(p,n);
+	}
+	template <typename U> bool operator==(const counting_allocator<U,category>&) const { return true; }
+	template <typename U> bool operator!=(const counting_allocator<U,category>&) const { return false; }
+};
+
+std::size_t memory_rss();
+void memory_stage(std::string name, std::map<std::string,double> &context);
+void memory_report(std::map<std::string,double> &context);
+
+#endif
@@ -0,0 +1,324 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <sstream>
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+#include "struct_point.h"
+#include "triangulation.h"
+#include "mesh_export.h"
+
+/**
+* \file mesh_export.cpp
+* \brief Fichier d'implémentation de l'export de la triangulation en maillage 3D binaire (PLY, STL ou glTF).
+* Les sommets et les triangles sont écrits directement depuis les points et la triangulation, par blocs d'un tampon
+* de taille fixe. Les triangles de delaunator étant dans le sens horaire vus du dessus, leurs sommets sont écrits dans
+* l'ordre (a,c,b) pour que les faces soient orientées vers la surface (profondeurs croissantes).
+* Les fichiers binaires sont en little endian, comme la mémoire des machines visées (x86, ARM).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct mesh_writer
+{
+	/**
+	* \brief Ecriture en flux d'un fichier binaire : les valeurs sont accumulées dans un tampon vidé dans le fichier dès qu'il est plein.
+	* \param file fichier de sortie.
+	* \param buffer tampon d'écriture.
+	*/
+	ofstream file;
+	vector<char> buffer;
+
+	template <typename T>
+	void put(const T &value){
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(),bytes,bytes+sizeof(T));
+		if (buffer.size() >= (1<<20)){
+			flush();
+		}
+	}
+	void put_text(const string &text){
+		buffer.insert(buffer.end(),text.begin(),text.end());
+	}
+	void flush(){
+		file.write(buffer.data(),buffer.size());
+		buffer.clear();
+	}
+};
+
+struct mesh_frame
+{
+	/**
+	* \brief Repère local des sommets : les coordonnées projetées sont trop grandes pour des float, elles sont
+	* écrites par rapport à l'origine (min_x,min_y,min_z) et éventuellement quantifiées sur bits bits par axe.
+	*/
+	double min_x, min_y, min_z;
+	double step_x = 1, step_y = 1, step_z = 1;
+	int bits = 0;
+};
+
+static void write_ply(mesh_writer &out, point_cloud &points, tin &t, mesh_frame &frame, size_t nb_faces);
+static void write_stl(mesh_writer &out, point_cloud &points, tin &t, mesh_frame &frame, size_t nb_faces);
+static void write_glb(mesh_writer &out, point_cloud &points, tin &t, mesh_frame &frame, size_t nb_faces);
+
+static uint16_t quantize(double value, double origin, double step){
+	/**
+	* \brief Quantifie une coordonnée sur 16 bits au plus.
+	*/
+	return uint16_t(max(0.0,min(65535.0,round((value-origin)/step))));
+}
+
+int export_mesh(string file_name, point_cloud &points, tin &t, map<string,double> &context){
+	/**
+	* \brief Exporte les triangles conservés de la triangulation (après la coupe des triangles trop longs) en maillage 3D binaire.
+	* Le format dépend de l'extension du fichier : .ply, .stl ou .glb (glTF binaire). Tous les points sont écrits comme sommets,
+	* dans leur ordre, pour que les indices des triangles soient ceux de la triangulation.
+	* \param file_name fichier à créer.
+	* \param points Points de la triangulation.
+	* \param t Triangulation à exporter.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de :
+	* - les limites du nuage de points (min_x,max_x,min_y,max_y,min_depth,max_depth)
+	* - la quantification des sommets (mesh_quantization : nombre de bits par axe, 0 = float, ignorée pour le STL)
+	* \return 1 si le fichier a été écrit, 0 sinon.
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Exporting mesh to " << file_name << "...";
+	time(&t0);
+
+	//format du fichier
+	string extension = file_name.substr(file_name.find_last_of('.')+1);
+	transform(extension.begin(),extension.end(),extension.begin(),::tolower);
+	if (extension != "ply" && extension != "stl" && extension != "glb"){
+		cout << " format inconnu (ply, stl ou glb)" << endl;
+		return 0;
+	}
+
+	//repère local et quantification
+	mesh_frame frame;
+	frame.min_x = context["min_x"];
+	frame.min_y = context["min_y"];
+	frame.min_z = min(context["min_depth"],context["max_depth"]);
+	frame.bits = (extension == "stl") ? 0 : min(16,max(0,int(context["mesh_quantization"])));
+	if (frame.bits > 0){
+		double levels = (1<<frame.bits)-1;
+		frame.step_x = max(context["max_x"]-frame.min_x,1e-9)/levels;
+		frame.step_y = max(context["max_y"]-frame.min_y,1e-9)/levels;
+		frame.step_z = max(abs(context["max_depth"]-context["min_depth"]),1e-9)/levels;
+	}
+
+	//nombre de triangles conservés
+	size_t nb_faces = 0;
+	for(char kept : t.kept){
+		nb_faces += kept;
+	}
+
+	mesh_writer out;
+	out.file.open(file_name,ios::binary);
+	if (out.file.fail()){
+		cout << " impossible de créer le fichier" << endl;
+		return 0;
+	}
+	if (extension == "ply"){
+		write_ply(out,points,t,frame,nb_faces);
+	}
+	else if (extension == "stl"){
+		write_stl(out,points,t,frame,nb_faces);
+	}
+	else{
+		write_glb(out,points,t,frame,nb_faces);
+	}
+	out.flush();
+	out.file.close();
+	if (out.file.fail()){
+		cout << " erreur d'écriture" << endl;
+		return 0;
+	}
+
+	time(&tf);
+	cout << " " << points.size() << " vertices, " << nb_faces << " triangles (" << tf-t0 << " s)" << endl; //affichage du temps d'execution
+	return 1;
+}
+
+static void write_ply(mesh_writer &out, point_cloud &points, tin &t, mesh_frame &frame, size_t nb_faces){
+	/**
+	* \brief Ecrit un PLY binaire : sommets en float (ou ushort si quantifiés) puis faces à 3 indices uint.
+	* L'origine et les pas de quantification sont donnés en commentaires de l'entête.
+	*/
+	ostringstream header;
+	header.precision(15);
+	header << "ply\nformat binary_little_endian 1.0\n";
+	header << "comment origin " << frame.min_x << " " << frame.min_y << " " << frame.min_z << "\n";
+	if (frame.bits > 0){
+		header << "comment scale " << frame.step_x << " " << frame.step_y << " " << frame.step_z << "\n";
+	}
+	string type = (frame.bits > 0) ? "ushort" : "float";
+	header << "element vertex " << points.size() << "\n";
+	header << "property " << type << " x\nproperty " << type << " y\nproperty " << type << " z\n";
+	header << "element face " << nb_faces << "\n";
+	header << "property list uchar uint vertex_indices\nend_header\n";
+	out.put_text(header.str());
+
+	for(size_t i = 0; i < points.size(); i++){
+		point p = points[i];
+		if (frame.bits > 0){
+			out.put(quantize(p.x,frame.min_x,frame.step_x));
+			out.put(quantize(p.y,frame.min_y,frame.step_y));
+			out.put(quantize(p.depth,frame.min_z,frame.step_z));
+		}
+		else{
+			out.put(float(p.x-frame.min_x));
+			out.put(float(p.y-frame.min_y));
+			out.put(float(p.depth-frame.min_z));
+		}
+	}
+	for(size_t i = 0; i < t.kept.size(); i++){
+		if (t.kept[i]){
+			out.put(uint8_t(3));
+			out.put(uint32_t(t.triangles[3*i]));
+			out.put(uint32_t(t.triangles[3*i+2]));
+			out.put(uint32_t(t.triangles[3*i+1]));
+		}
+	}
+}
+
+static void write_stl(mesh_writer &out, point_cloud &points, tin &t, mesh_frame &frame, size_t nb_faces){
+	/**
+	* \brief Ecrit un STL binaire : entête de 80 octets (avec l'origine), puis normale et sommets en float de chaque triangle.
+	*/
+	ostringstream header;
+	header.precision(12);
+	header << "create_raster origin " << frame.min_x << " " << frame.min_y << " " << frame.min_z;
+	string text = header.str();
+	text.resize(80,' ');
+	out.put_text(text);
+	out.put(uint32_t(nb_faces));
+
+	for(size_t i = 0; i < t.kept.size(); i++){
+		if (!t.kept[i]){
+			continue;
+		}
+		float v[3][3];
+		const int order[3] = {0,2,1};
+		for(int k = 0; k < 3; k++){
+			point p = points[t.triangles[3*i+order[k]]];
+			v[k][0] = p.x-frame.min_x;
+			v[k][1] = p.y-frame.min_y;
+			v[k][2] = p.depth-frame.min_z;
+		}
+		float ux = v[1][0]-v[0][0], uy = v[1][1]-v[0][1], uz = v[1][2]-v[0][2];
+		float wx = v[2][0]-v[0][0], wy = v[2][1]-v[0][1], wz = v[2][2]-v[0][2];
+		float n[3] = {uy*wz-uz*wy,uz*wx-ux*wz,ux*wy-uy*wx};
+		float norm = sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+		for(int k = 0; k < 3; k++){
+			out.put(norm > 0 ? n[k]/norm : 0.0f);
+		}
+		for(int k = 0; k < 3; k++){
+			out.put(v[k][0]);
+			out.put(v[k][1]);
+			out.put(v[k][2]);
+		}
+		out.put(uint16_t(0));
+	}
+}
+
+static void write_glb(mesh_writer &out, point_cloud &points, tin &t, mesh_frame &frame, size_t nb_faces){
+	/**
+	* \brief Ecrit un glTF binaire (.glb) : un bloc JSON qui décrit le maillage puis un bloc binaire (sommets puis indices uint).
+	* glTF ayant l'axe y vers le haut, un sommet est (x-min_x, profondeur-min_z, min_y-y).
+	* Les sommets quantifiés sont des ushort (extension KHR_mesh_quantization), le pas est appliqué par l'échelle du noeud
+	* (négative en z, les valeurs quantifiées étant y-min_y).
+	* L'origine en coordonnées projetées est donnée dans "extras" de l'asset.
+	*/
+	size_t nb_vertices = points.size();
+	size_t stride = (frame.bits > 0) ? 8 : 12; //ushort x3 complétés à 4 octets, ou float x3
+	size_t vertices_bytes = nb_vertices*stride;
+	size_t indices_bytes = nb_faces*3*sizeof(uint32_t);
+	size_t bin_bytes = vertices_bytes+indices_bytes;
+
+	//bornes des valeurs écrites (obligatoires pour POSITION)
+	float low[3] = {1e30f,1e30f,1e30f}, high[3] = {-1e30f,-1e30f,-1e30f};
+	for(size_t i = 0; i < points.size(); i++){
+		point p = points[i];
+		float v[3]; //valeurs telles qu'écrites (les ushort sont exacts en float)
+		if (frame.bits > 0){
+			v[0] = quantize(p.x,frame.min_x,frame.step_x);
+			v[1] = quantize(p.depth,frame.min_z,frame.step_z);
+			v[2] = quantize(p.y,frame.min_y,frame.step_y);
+		}
+		else{
+			v[0] = p.x-frame.min_x;
+			v[1] = p.depth-frame.min_z;
+			v[2] = frame.min_y-p.y;
+		}
+		for(int k = 0; k < 3; k++){
+			low[k] = min(low[k],v[k]);
+			high[k] = max(high[k],v[k]);
+		}
+	}
+
+	//description JSON
+	ostringstream json;
+	json.precision(17); //bornes exactes des float écrits
+	json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"create_raster\",\"extras\":{\"origin\":["
+		<< frame.min_x << "," << frame.min_y << "," << frame.min_z << "]}},";
+	if (frame.bits > 0){
+		json << "\"extensionsUsed\":[\"KHR_mesh_quantization\"],\"extensionsRequired\":[\"KHR_mesh_quantization\"],";
+	}
+	json << "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0";
+	if (frame.bits > 0){
+		json << ",\"scale\":[" << frame.step_x << "," << frame.step_z << "," << -frame.step_y << "]";
+	}
+	json << "}],\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}],";
+	json << "\"buffers\":[{\"byteLength\":" << bin_bytes << "}],";
+	json << "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << vertices_bytes << ",\"byteStride\":" << stride << ",\"target\":34962},"
+		<< "{\"buffer\":0,\"byteOffset\":" << vertices_bytes << ",\"byteLength\":" << indices_bytes << ",\"target\":34963}],";
+	json << "\"accessors\":[{\"bufferView\":0,\"componentType\":" << ((frame.bits > 0) ? 5123 : 5126)
+		<< ",\"count\":" << nb_vertices << ",\"type\":\"VEC3\",\"min\":[" << low[0] << "," << low[1] << "," << low[2]
+		<< "],\"max\":[" << high[0] << "," << high[1] << "," << high[2] << "]},"
+		<< "{\"bufferView\":1,\"componentType\":5125,\"count\":" << 3*nb_faces << ",\"type\":\"SCALAR\"}]}";
+	string text = json.str();
+	text.resize((text.size()+3)/4*4,' '); //blocs alignés sur 4 octets
+
+	//entête et blocs
+	out.put(uint32_t(0x46546C67)); //"glTF"
+	out.put(uint32_t(2));
+	out.put(uint32_t(12+8+text.size()+8+bin_bytes));
+	out.put(uint32_t(text.size()));
+	out.put(uint32_t(0x4E4F534A)); //"JSON"
+	out.put_text(text);
+	out.put(uint32_t(bin_bytes));
+	out.put(uint32_t(0x004E4942)); //"BIN"
+
+	for(size_t i = 0; i < points.size(); i++){
+		point p = points[i];
+		if (frame.bits > 0){
+			out.put(quantize(p.x,frame.min_x,frame.step_x));
+			out.put(quantize(p.depth,frame.min_z,frame.step_z));
+			out.put(quantize(p.y,frame.min_y,frame.step_y));
+			out.put(uint16_t(0));
+		}
+		else{
+			out.put(float(p.x-frame.min_x));
+			out.put(float(p.depth-frame.min_z));
+			out.put(float(frame.min_y-p.y));
+		}
+	}
+	for(size_t i = 0; i < t.kept.size(); i++){
+		if (t.kept[i]){
+			out.put(uint32_t(t.triangles[3*i]));
+			out.put(uint32_t(t.triangles[3*i+2]));
+			out.put(uint32_t(t.triangles[3*i+1]));
+		}
+	}
+}
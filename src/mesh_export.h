@@ -0,0 +1,20 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+
+#ifndef MESH_EXPORT_H
+#define MESH_EXPORT_H
+
+/**
+* \file mesh_export.h
+* \brief Fichier de déclaration de l'export de la triangulation en maillage 3D binaire (PLY, STL ou glTF).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int export_mesh(std::string file_name, point_cloud &points, tin &t, std::map<std::string,double> &context);
+
+#endif
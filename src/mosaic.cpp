@@ -0,0 +1,199 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+#include "struct_point.h"
+#include "parallel.h"
+#include "init_points_pixels.h"
+#include "thinning.h"
+#include "mosaic.h"
+
+/**
+* \file mosaic.cpp
+* \brief Fichier d'implémentation de la mosaïque de relevés.
+* Les fichiers sont lus et projetés en même temps (chacun avec une part des threads), puis leurs points sont rassemblés
+* dans l'ordre des fichiers. Une grille de cases de overlap_cell pixels repère les recouvrements : les points d'une case
+* qui ne contient qu'un relevé sont tous gardés, ceux d'une case partagée par plusieurs relevés sont remplacés selon la règle
+* overlap : les points du relevé le plus récent (le dernier de la liste), le point le moins profond, ou la moyenne des points.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct overlap_cell
+{
+	/**
+	* \brief Relevés et points d'une case de la grille des recouvrements.
+	* \param first indice du premier point de la case.
+	* \param shoalest indice du point le moins profond.
+	* \param oldest,newest plus petit et plus grand numéro de relevé des points de la case.
+	* \param sum_x,sum_y,sum_depth,nb sommes pour la moyenne.
+	*/
+	size_t first = 0, shoalest = 0;
+	uint32_t oldest = 0, newest = 0;
+	double sum_x = 0, sum_y = 0, sum_depth = 0;
+	size_t nb = 0;
+};
+
+int read_overlap(string str, map<string,double> &context){
+	/**
+	* \brief Lis la règle de résolution des recouvrements : newest (le relevé le plus récent), shoalest (le point le moins profond)
+	* ou mean (moyenne des points de la case).
+	* \param str texte à analyser.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales), initialise overlap.
+	* \return 1 si la règle est valide, 0 sinon.
+	*/
+	vector<string> policies = {"newest","shoalest","mean"};
+	for(size_t i = 0; i < policies.size(); i++){
+		if (str == policies[i]){
+			context["overlap"] = i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int get_mosaic_points(const vector<string> &file_names, point_cloud *v, map<string,double> &context){
+	/**
+	* \brief Lis et projette les points de plusieurs relevés en parallèle, puis résout leurs recouvrements (voir mosaic.cpp).
+	* \param file_names noms des fichiers des relevés, du plus ancien au plus récent.
+	* \param v nuage dans lequel sauvegarder les points de la mosaïque.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction initialise les limites du nuage de points et utilise la règle des recouvrements (overlap),
+	* la taille des cases en pixels (overlap_cell), la taille de l'image (width,height) et le nombre de threads (nb_threads).
+	* \return 1 si la lecture de tous les relevés a réussi, 0 sinon.
+	*/
+
+	//lecture des relevés, plusieurs à la fois
+	size_t nb_files = file_names.size();
+	int nb_threads = max(1,int(context["nb_threads"]));
+	int nb_parallel = min<int>(nb_threads,nb_files);
+	vector<point_cloud> clouds(nb_files);
+	vector<map<string,double>> contexts(nb_files,context);
+	vector<int> results(nb_files,0);
+	parallel_for(nb_files,nb_parallel,[&](size_t begin, size_t end, int){
+		for(size_t f = begin; f < end; f++){
+			contexts[f]["nb_threads"] = max(1,nb_threads/nb_parallel);
+			results[f] = get_projected_points(file_names[f],&clouds[f],contexts[f]); //(Voir init_point_pixels.cpp)
+		}
+	});
+
+	//rassemblement dans l'ordre des relevés et limites de la mosaïque
+	time_t t0,tf;
+	time(&t0);
+	size_t nb_points = 0;
+	for(size_t f = 0; f < nb_files; f++){
+		cout << "- Survey " << f+1 << "/" << nb_files << " (" << file_names[f] << ") : " << clouds[f].size() << " points" << endl;
+		if (results[f] == 0){
+			return 0;
+		}
+		nb_points += clouds[f].size();
+		context["min_x"] = min(context["min_x"],contexts[f]["min_x"]);
+		context["max_x"] = max(context["max_x"],contexts[f]["max_x"]);
+		context["min_y"] = min(context["min_y"],contexts[f]["min_y"]);
+		context["max_y"] = max(context["max_y"],contexts[f]["max_y"]);
+		context["min_depth"] = max(context["min_depth"],contexts[f]["min_depth"]); //inversion min, max car profondeur négative
+		context["max_depth"] = min(context["max_depth"],contexts[f]["max_depth"]);
+	}
+	cout << "- Resolving overlaps...";
+	vector<uint32_t> source(nb_points);
+	v->reserve(nb_points);
+	for(size_t f = 0; f < nb_files; f++){
+		fill(source.begin()+v->size(),source.begin()+v->size()+clouds[f].size(),uint32_t(f));
+		v->coords.insert(v->coords.end(),clouds[f].coords.begin(),clouds[f].coords.end());
+		v->depth.insert(v->depth.end(),clouds[f].depth.begin(),clouds[f].depth.end());
+		clouds[f].clear();
+	}
+	point_cloud &points = *v;
+
+	//case de chaque point
+	int policy = context["overlap"];
+	double min_x = context["min_x"];
+	double min_y = context["min_y"];
+	double lg_pix = (context["max_x"]-min_x)/context["width"];
+	double h_pix = (context["max_y"]-min_y)/context["height"];
+	double cell = max(context["overlap_cell"]*min(lg_pix,h_pix),1e-9);
+	vector<cell_key> keys(nb_points);
+	parallel_for(nb_points,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			keys[i] = {int64_t(floor((points.x(i)-min_x)/cell)),int64_t(floor((points.y(i)-min_y)/cell))};
+		}
+	});
+
+	//le thread t traite les cases dont le hash vaut t modulo nb_threads (voir thin_points)
+	vector<vector<size_t>> buckets;
+	partition_cells(keys,nb_threads,buckets); //(Voir thinning.cpp)
+	vector<char> kept(nb_points,1);
+	vector<size_t> nb_shared(nb_threads,0);
+	parallel_for(nb_threads,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t t = begin; t < end; t++){
+			unordered_map<cell_key,overlap_cell,cell_key_hash> cells;
+			for(size_t i : buckets[t]){
+				auto found = cells.find(keys[i]);
+				if (found == cells.end()){
+					found = cells.emplace(keys[i],overlap_cell{i,i,source[i],source[i]}).first;
+				}
+				overlap_cell &c = found->second;
+				c.oldest = min(c.oldest,source[i]);
+				c.newest = max(c.newest,source[i]);
+				c.sum_x += points.x(i);
+				c.sum_y += points.y(i);
+				c.sum_depth += points.depth[i];
+				c.nb++;
+				if (points.depth[i] > points.depth[c.shoalest]){ //profondeurs négatives
+					c.shoalest = i;
+				}
+			}
+
+			//points gardés des cases partagées par plusieurs relevés
+			for(size_t i : buckets[t]){
+				overlap_cell &c = cells.find(keys[i])->second;
+				if (c.oldest == c.newest){
+					continue;
+				}
+				if (policy == 0){
+					kept[i] = (source[i] == c.newest);
+				}
+				else if (policy == 1){
+					kept[i] = (i == c.shoalest);
+				}
+				else{
+					kept[i] = (i == c.first);
+					if (kept[i]){
+						points.set(i,{c.sum_x/c.nb,c.sum_y/c.nb,c.sum_depth/c.nb});
+					}
+				}
+				nb_shared[t] += (i == c.first);
+			}
+		}
+	});
+
+	vector<vector<size_t>>().swap(buckets);
+
+	//suppression des points remplacés, dans l'ordre des relevés
+	size_t nb_kept = 0;
+	for(size_t i = 0; i < nb_points; i++){
+		if (kept[i]){
+			points.set(nb_kept++,points[i]);
+		}
+	}
+	points.resize(nb_kept);
+	context["nb_points"] = nb_kept;
+	points.coords.shrink_to_fit();
+	points.depth.shrink_to_fit();
+
+	size_t shared = 0;
+	for(size_t n : nb_shared){
+		shared += n;
+	}
+	time(&tf);
+	cout << " " << shared << " overlapping cells, " << nb_points << " -> " << nb_kept << " points (" << tf-t0 << " s)" << endl; //affichage du temps d'execution
+	return 1;
+}
@@ -0,0 +1,21 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+
+#ifndef MOSAIC_H
+#define MOSAIC_H
+
+/**
+* \file mosaic.h
+* \brief Fichier de déclaration de la mosaïque de relevés : plusieurs fichiers voisins ou qui se recouvrent sont lus
+* en parallèle dans le même système de coordonnées, puis les recouvrements sont résolus case par case.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int read_overlap(std::string str, std::map<std::string,double> &context);
+int get_mosaic_points(const std::vector<std::string> &file_names, point_cloud *v, std::map<std::string,double> &context);
+
+#endif
@@ -0,0 +1,96 @@
+#include <cstdlib>
+#include <vector>
+#include <thread> //threads
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/**
+* \file parallel.h
+* \brief Fichier de déclaration des outils de parallélisation (boucles sur plusieurs threads, files entre étapes d'un pipeline).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+inline int default_nb_threads(){
+	/**
+	* \brief Renvoie le nombre de threads utilisés par défaut (nombre de coeurs de la machine).
+	* \return Nombre de threads, au moins 1.
+	*/
+	int nb = std::thread::hardware_concurrency();
+	return std::max(1,nb);
+}
+
+template <typename F>
+void parallel_for(std::size_t n, int nb_threads, F f){
+	/**
+	* \brief Découpe l'intervalle [0,n[ en blocs contigus et appelle f(debut,fin,id_thread) sur chaque bloc dans un thread différent.
+	* Le thread appelant traite le premier bloc, il n'y a donc aucun thread créé si nb_threads vaut 1.
+	* \param n Nombre d'itérations de la boucle.
+	* \param nb_threads Nombre de threads à utiliser.
+	* \param f Fonction à appeler sur chaque bloc.
+	*/
+	std::size_t nb = std::max(1,std::min<int>(nb_threads,std::max<std::size_t>(n,1)));
+	std::size_t block = (n+nb-1)/nb;
+	std::vector<std::thread> threads;
+	for(std::size_t t = 1; t < nb; t++){
+		std::size_t begin = std::min(n,t*block);
+		std::size_t end = std::min(n,begin+block);
+		threads.emplace_back(f,begin,end,int(t));
+	}
+	f(std::size_t(0),std::min(n,block),0);
+	for(auto &th : threads){
+		th.join();
+	}
+}
+
+template <typename T>
+class bounded_queue
+{
+/**
+* \class bounded_queue
+* \brief File de taille limitée entre deux threads : push attend qu'il y ait de la place, pop attend qu'il y ait un élément.
+* Une fois fermée, pop renvoie false quand la file est vide.
+*/
+public:
+	bounded_queue(std::size_t capacity) : capacity(std::max<std::size_t>(capacity,1)) {}
+
+	void push(T item){
+		std::unique_lock<std::mutex> lock(mutex);
+		not_full.wait(lock,[&]{ return items.size() < capacity; });
+		items.push_back(std::move(item));
+		not_empty.notify_one();
+	}
+
+	bool pop(T &item){
+		std::unique_lock<std::mutex> lock(mutex);
+		not_empty.wait(lock,[&]{ return !items.empty() || closed; });
+		if (items.empty()){
+			return false;
+		}
+		item = std::move(items.front());
+		items.pop_front();
+		not_full.notify_one();
+		return true;
+	}
+
+	void close(){
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		not_empty.notify_all();
+	}
+
+private:
+	std::size_t capacity;
+	std::deque<T> items;
+	bool closed = false;
+	std::mutex mutex;
+	std::condition_variable not_full;
+	std::condition_variable not_empty;
+};
+
+#endif
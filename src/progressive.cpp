@@ -0,0 +1,203 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cstdio>
+#include "parallel.h"
+#include "Triangle.h"
+#include "triangulation.h"
+#include "init_points_pixels.h"
+#include "generate_image.h"
+#include "shading.h"
+#include "progressive.h"
+
+/**
+* \file progressive.cpp
+* \brief Fichier d'implémentation du rendu progressif.
+* Avant l'image finale, des aperçus de largeur width/2^progressive, ..., width/2 sont écrits dans l'image l'un après l'autre.
+* Ils utilisent la même triangulation (et les mêmes normales aux sommets) que le rendu final. Un aperçu qui a moins de pixels
+* que de triangles est rendu pixel par pixel en cherchant dans l'index spatial des triangles celui qui contient le centre
+* du pixel, son coût dépend donc du nombre de pixels et non du nombre de triangles ; les autres sont rendus comme l'image finale.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+float sign(double x0, double y0, const point &p_2, const point &p_3); //(Voir Triangle.cpp)
+static void sample_pixels(point_cloud &points, tin &t, triangle_grid &grid, vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, normal_buffer *pixels_normals);
+static bool write_preview(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, const string &image_name);
+
+int render_previews(point_cloud &points, tin &t, map<string,double> &context, string image_name){
+	/**
+	* \brief Écrit les aperçus du rendu progressif (progressive niveaux, du plus grossier au plus fin) dans image_name.
+	* Chaque aperçu est écrit sous un nom temporaire puis renommé, un visualiseur ne lit donc jamais une image incomplète.
+	* \param points Points de la triangulation.
+	* \param t Triangulation du rendu final.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise le nombre de niveaux d'aperçus (progressive), la taille de l'image (width,height)
+	* et les paramètres du rendu (voir color_triangles).
+	* \param image_name Image dans laquelle écrire les aperçus, remplacée ensuite par l'image finale.
+	* \return Nombre d'aperçus écrits.
+	*/
+	int nb_levels = context["progressive"];
+	size_t nb_kept = count(t.kept.begin(),t.kept.end(),1);
+	triangle_grid grid; //construit au premier aperçu rendu pixel par pixel
+	int nb_written = 0;
+	auto start = chrono::steady_clock::now();
+
+	for(int level = nb_levels; level >= 1; level--){
+		auto t0 = chrono::steady_clock::now();
+		map<string,double> level_context = context;
+		level_context["width"] = max(1,int(context["width"])>>level);
+		level_context["height"] = max(1,int(context["height"])>>level);
+		set_pixel_size(level_context); //(Voir init_point_pixels.cpp)
+		size_t nb_pixels = size_t(level_context["width"])*size_t(level_context["height"]);
+
+		vector<int> pixels;
+		vector<double> pixels_illumination;
+		create_pixels(pixels,pixels_illumination,level_context);
+		if (nb_pixels < nb_kept){ //pixels plus grands que les triangles
+			if (grid.cells.empty()){
+				build_triangle_grid(points,t,context,grid);
+			}
+			normal_buffer normals;
+			if (context["shading"] == 1){
+				if (t.vertex_normals.empty()){
+					compute_vertex_normals(points,t.triangles,t.kept,t.vertex_normals,context["nb_threads"]);
+				}
+				normals.x.assign(nb_pixels,0);
+				normals.y.assign(nb_pixels,0);
+				normals.z.assign(nb_pixels,0);
+			}
+			sample_pixels(points,t,grid,pixels,pixels_illumination,level_context,(context["shading"] == 1) ? &normals : nullptr);
+			if (context["shading"] == 1){
+				compute_smooth_illumination(normals,pixels_illumination,level_context);
+			}
+			if (context["shadows"] == 1){
+				compute_cast_shadows(pixels,pixels_illumination,level_context);
+			}
+		}
+		else{
+			color_triangles(points,t,pixels,pixels_illumination,level_context);
+		}
+		if (!write_preview(pixels,pixels_illumination,level_context,image_name)){
+			cout << "echec d'écriture de l'aperçu " << image_name << endl;
+			return nb_written;
+		}
+		nb_written++;
+		double seconds = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+		double elapsed = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+		cout << "- Preview 1/" << (1<<level) << " (" << level_context["width"] << "x" << level_context["height"] << ") written in "
+		<< seconds << " s, " << elapsed << " s since the first one" << endl;
+	}
+	return nb_written;
+}
+
+static void sample_pixels(point_cloud &points, tin &t, triangle_grid &grid, vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, normal_buffer *pixels_normals){
+	/**
+	* \brief Colore chaque pixel avec le premier triangle conservé (dans l'ordre de la triangulation) qui contient son centre,
+	* comme find_pixels, l'image est donc la même qu'avec color_triangles. Les lignes sont réparties entre les threads.
+	* \param points Points de la triangulation.
+	* \param t Triangulation.
+	* \param grid Index spatial des triangles conservés (voir build_triangle_grid).
+	* \param pixels Liste des pixels.
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise la taille et les limites de l'image, la direction du soleil (sun_dir_x,sun_dir_y,sun_dir_z)
+	* et le nombre de threads (nb_threads).
+	* \param pixels_normals Normales interpolées des pixels (ombrage lisse), ignorées si nullptr.
+	*/
+	set_raster_parameters(context); //pour convert_to_color
+	int width = context["width"];
+	int height = context["height"];
+	double lg_pix = context["lg_pix"];
+	double h_pix = context["h_pix"];
+	double min_x = context["min_x"];
+	double max_y = context["max_y"];
+	double margin = t.lim_triangle_lg; //un point d'un triangle conservé est à moins de lim_triangle_lg de son centre
+	vector<double> sun_dir = {context["sun_dir_x"],context["sun_dir_y"],context["sun_dir_z"]};
+
+	parallel_for(height,context["nb_threads"],[&](size_t begin, size_t end, int){
+		vector<double> light = sun_dir;
+		for(int y = begin+1; y <= int(end); y++){
+			double center_y = (max_y-(y*h_pix))+(h_pix/2); //centre du pixel selon y (voir find_pixels)
+			int cy0 = max(0,int((center_y-margin-grid.min_y)/grid.cell));
+			int cy1 = min(grid.nb_y-1,int((center_y+margin-grid.min_y)/grid.cell));
+			for(int x = 1; x <= width; x++){
+				double center_x = ((x*lg_pix)+min_x)-(lg_pix/2); //centre du pixel selon x
+				int cx0 = max(0,int((center_x-margin-grid.min_x)/grid.cell));
+				int cx1 = min(grid.nb_x-1,int((center_x+margin-grid.min_x)/grid.cell));
+
+				//premier triangle qui contient le centre du pixel (même test que Triangle::contain)
+				size_t first = numeric_limits<size_t>::max();
+				for(int cy = cy0; cy <= cy1; cy++){
+					for(int cx = cx0; cx <= cx1; cx++){
+						for(size_t i : grid.cells[size_t(cy)*grid.nb_x+cx]){
+							if (i >= first){
+								continue;
+							}
+							point p1 = points[t.triangles[3*i]];
+							point p2 = points[t.triangles[3*i+1]];
+							point p3 = points[t.triangles[3*i+2]];
+							float c1 = sign(center_x,center_y,p1,p2);
+							float c2 = sign(center_x,center_y,p2,p3);
+							float c3 = sign(center_x,center_y,p3,p1);
+							bool has_neg = (c1 < 0) || (c2 < 0) || (c3 < 0);
+							bool has_pos = (c1 > 0) || (c2 > 0) || (c3 > 0);
+							if (!(has_neg && has_pos)){
+								first = i;
+							}
+						}
+					}
+				}
+				if (first == numeric_limits<size_t>::max()){
+					continue;
+				}
+
+				int pix_index = (y*width)-(width-x);
+				Triangle T(points[t.triangles[3*first]],points[t.triangles[3*first+1]],points[t.triangles[3*first+2]]);
+				T.compute_illumination(light);
+				pixels_illumination[pix_index-1] = T.illumination;
+				pixels[pix_index-1] = convert_to_color(T.compute_depth(center_x,center_y));
+				if (pixels_normals != nullptr){
+					T.n1 = &(t.vertex_normals[3*t.triangles[3*first]]);
+					T.n2 = &(t.vertex_normals[3*t.triangles[3*first+1]]);
+					T.n3 = &(t.vertex_normals[3*t.triangles[3*first+2]]);
+					float n[3];
+					T.interpolate_normal(center_x,center_y,n);
+					pixels_normals->x[pix_index-1] = n[0];
+					pixels_normals->y[pix_index-1] = n[1];
+					pixels_normals->z[pix_index-1] = n[2];
+				}
+			}
+		}
+	});
+}
+
+static bool write_preview(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, const string &image_name){
+	/**
+	* \brief Écrit un aperçu sous un nom temporaire puis le renomme en image_name.
+	* \param pixels Liste des pixels.
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param image_name Image à remplacer.
+	* \return true si l'écriture a réussi.
+	*/
+	vector<char> image;
+	colorize_pixels(pixels,pixels_illumination,context,image);
+	string temp_name = image_name+".preview";
+	ofstream image_file(temp_name,ios::binary);
+	image_file << image_header(context["width"],context["height"]);
+	image_file.write(image.data(),image.size());
+	image_file.close();
+	if (image_file.fail()){
+		return false;
+	}
+	return rename(temp_name.c_str(),image_name.c_str()) == 0;
+}
@@ -0,0 +1,20 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+
+#ifndef PROGRESSIVE_H
+#define PROGRESSIVE_H
+
+/**
+* \file progressive.h
+* \brief Fichier de déclaration du rendu progressif : aperçus de plus en plus fins écrits avant l'image finale.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int render_previews(point_cloud &points, tin &t, std::map<std::string,double> &context, std::string image_name = "raster.ppm");
+
+#endif
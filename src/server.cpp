@@ -0,0 +1,429 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <sstream>
+#include <string>
+#include <chrono> //mesure des temps de réponse
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <limits>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h> //socket Unix
+#include <sys/un.h>
+#include <sys/mman.h> //mémoire partagée
+#include "struct_point.h"
+#include "init_points_pixels.h"
+#include "triangulation.h"
+#include "generate_image.h"
+#include "shading.h"
+#include "simplification.h"
+#include "deferred.h"
+#include "server.h"
+
+/**
+* \file server.cpp
+* \brief Fichier d'implémentation du mode serveur : les points et la triangulation restent en mémoire et
+* les rendus sont demandés en JSON sur une socket Unix locale.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct deferred_cache
+{
+	/**
+	* \brief Tampon de visibilité du dernier rendu, réutilisé si le rendu suivant a la même géométrie (voir deferred.h).
+	* \param key taille, fenêtre, mode d'ombrage et niveau de détail du rendu.
+	* \param raster tampon de visibilité.
+	* \param nb_triangles nombre de triangles sélectionnés pour ce rendu.
+	*/
+	vector<double> key;
+	deferred_raster raster;
+	size_t nb_triangles = 0;
+};
+
+static string handle_request(const string &request, point_cloud &points, tin &t, triangle_grid &grid, vector<lod_level> &lods, deferred_cache &cache, map<string,double> &context, bool &stop);
+static string read_request(int client);
+static int write_shm(string name, string &header, vector<char> &image);
+static string json_error(string message);
+static string json_string(const string &str);
+
+int run_server(string socket_path, point_cloud &points, map<string,double> &context){
+	/**
+	* \brief Triangule une seule fois le nuage de points puis répond aux demandes de rendu reçues sur une socket Unix.
+	* Une demande est un objet JSON sur une ligne, par exemple :
+	* {"width":1000,"min_x":-1000,"max_x":500,"min_y":-200,"max_y":1300,"sun_azimuth":315,"sun_elevation":30,"shading":"smooth","output":"raster.ppm"}
+	* Toutes les clés sont facultatives. "shm" remplace "output" pour écrire l'image dans une mémoire partagée POSIX.
+	* {"command":"info"} renvoie les limites du relevé et {"command":"shutdown"} arrête le serveur.
+	* La réponse est un objet JSON sur une ligne avec "status" ("ok" ou "error").
+	* \param socket_path chemin de la socket Unix à créer.
+	* \param points Points projetés du relevé.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales), paramètres par défaut des rendus.
+	* \return 1 si le serveur s'est arrêté normalement, 0 en cas d'erreur.
+	*/
+
+	//triangulation et index spatial conservés entre les rendus
+	cout << endl<<"Triangulation :"<<endl;
+	tin t;
+	triangulate(points,t,context);
+	triangle_grid grid;
+	build_triangle_grid(points,t,context,grid);
+
+	//niveaux de détail pour les rendus dont les pixels sont plus grands que les triangles
+	vector<lod_level> lods;
+	if (context["lod"] == 1){
+		build_lods(points,t,context,lods,numeric_limits<double>::max());
+		for(auto &level : lods){
+			build_triangle_grid(level.points,level.t,context,level.grid);
+		}
+	}
+
+	//création de la socket
+	sockaddr_un address;
+	memset(&address,0,sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(address.sun_path)){
+		cout << "Chemin de socket trop long : " << socket_path << endl;
+		return 0;
+	}
+	strcpy(address.sun_path,socket_path.c_str());
+	int server = socket(AF_UNIX,SOCK_STREAM,0);
+	if (server < 0){
+		cout << "Impossible de créer la socket : " << strerror(errno) << endl;
+		return 0;
+	}
+	unlink(socket_path.c_str()); //socket d'une exécution précédente
+	if (bind(server,(sockaddr*)&address,sizeof(address)) < 0 || listen(server,16) < 0){
+		cout << "Impossible d'écouter sur " << socket_path << " : " << strerror(errno) << endl;
+		close(server);
+		return 0;
+	}
+	cout << endl << "Server listening on " << socket_path << endl;
+
+	//traitement des demandes les unes après les autres (chaque rendu est parallélisé)
+	deferred_cache cache;
+	bool stop = false;
+	while(!stop){
+		int client = accept(server,nullptr,nullptr);
+		if (client < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			cout << "Erreur de connexion : " << strerror(errno) << endl;
+			break;
+		}
+		string request = read_request(client);
+		string response = handle_request(request,points,t,grid,lods,cache,context,stop)+"\n";
+		size_t sent = 0;
+		while(sent < response.size()){
+			ssize_t n = send(client,response.data()+sent,response.size()-sent,MSG_NOSIGNAL);
+			if (n <= 0){
+				break;
+			}
+			sent += n;
+		}
+		close(client);
+	}
+
+	close(server);
+	unlink(socket_path.c_str());
+	cout << "Server stopped." << endl;
+	return 1;
+}
+
+static string handle_request(const string &request, point_cloud &points, tin &t, triangle_grid &grid, vector<lod_level> &lods, deferred_cache &cache, map<string,double> &context, bool &stop){
+	/**
+	* \brief Exécute une demande JSON et renvoie la réponse JSON.
+	* \param request demande reçue.
+	* \param points Points projetés du relevé.
+	* \param t Triangulation du relevé.
+	* \param grid Index spatial des triangles.
+	* \param lods Niveaux de détail (vide si lod vaut 0), choisis selon la taille des pixels du rendu.
+	* \param cache Tampon de visibilité du rendu précédent : une demande qui ne change que l'éclairage n'est pas rasterisée à nouveau.
+	* \param context Paramètres par défaut des rendus.
+	* \param stop mis à vrai si la demande est l'arrêt du serveur.
+	*/
+	auto start = chrono::steady_clock::now();
+	map<string,double> numbers;
+	map<string,string> strings;
+	if (read_json(request,numbers,strings) == 0){
+		return json_error("invalid JSON request");
+	}
+
+	string command = strings.count("command") ? strings["command"] : "render";
+	ostringstream response;
+	response.precision(15);
+	if (command == "shutdown"){
+		stop = true;
+		return "{\"status\":\"ok\"}";
+	}
+	if (command == "info"){
+		response << "{\"status\":\"ok\",\"points\":" << points.size() << ",\"triangles\":" << t.triangles.size()/3
+		<< ",\"min_x\":" << context["min_x"] << ",\"max_x\":" << context["max_x"]
+		<< ",\"min_y\":" << context["min_y"] << ",\"max_y\":" << context["max_y"]
+		<< ",\"min_depth\":" << context["min_depth"] << ",\"max_depth\":" << context["max_depth"] << "}";
+		return response.str();
+	}
+	if (command != "render"){
+		return json_error("unknown command "+command);
+	}
+
+	//paramètres du rendu : ceux par défaut, remplacés par ceux de la demande
+	map<string,double> render_context = context;
+	for(string key : {"width","height","min_x","max_x","min_y","max_y","sun_azimuth","sun_elevation","light_elevation","shadows","shadow_factor","shading"}){
+		if (numbers.count(key)){
+			render_context[key] = numbers[key];
+		}
+	}
+	if (numbers.count("width") && !numbers.count("height")){ //image carrée par défaut, comme en ligne de commande
+		render_context["height"] = render_context["width"];
+	}
+	if (strings.count("shading")){
+		if (strings["shading"] != "flat" && strings["shading"] != "smooth"){
+			return json_error("shading must be flat or smooth");
+		}
+		render_context["shading"] = (strings["shading"] == "smooth") ? 1 : 0;
+	}
+	if (strings.count("lights") && read_lights(strings["lights"],render_context) == 0){
+		return json_error("invalid lights");
+	}
+	set_sun_dir(render_context);
+	int width = render_context["width"];
+	int height = render_context["height"];
+	if (width <= 0 || height <= 0 || render_context["min_x"] >= render_context["max_x"] || render_context["min_y"] >= render_context["max_y"]){
+		return json_error("invalid image size or window");
+	}
+	render_context["width"] = width;
+	render_context["height"] = height;
+
+	//rendu sur les seuls triangles de la fenêtre
+	set_pixel_size(render_context);
+	point_cloud* render_points = &points;
+	tin* render_tin = &t;
+	triangle_grid* render_grid = &grid;
+	lod_level* level = select_lod(lods,max(render_context["lg_pix"],render_context["h_pix"]));
+	if (level != nullptr){
+		render_points = &level->points;
+		render_tin = &level->t;
+		render_grid = &level->grid;
+	}
+
+	//même géométrie que le rendu précédent : seuls l'ombrage et les couleurs sont recalculés (voir deferred.cpp)
+	vector<double> key = {double(width),double(height),render_context["min_x"],render_context["max_x"],render_context["min_y"],render_context["max_y"],
+		render_context["shading"],double((level == nullptr) ? -1 : level-lods.data())};
+	bool deferred = (cache.key == key);
+	vector<double> pixels_illumination;
+	if (!deferred){
+		vector<size_t> selection;
+		select_triangles(*render_grid,*render_tin,render_context["min_x"],render_context["max_x"],render_context["min_y"],render_context["max_y"],selection);
+		capture_deferred(*render_points,*render_tin,render_context,&selection,cache.raster,pixels_illumination);
+		cache.key = key;
+		cache.nb_triangles = selection.size();
+	}
+	shade_deferred(cache.raster,render_context,pixels_illumination);
+	vector<char> image;
+	colorize_pixels(cache.raster.pixels,pixels_illumination,render_context,image);
+	string header = image_header(width,height);
+
+	//écriture dans un fichier ou dans une mémoire partagée
+	string output;
+	if (strings.count("shm")){
+		output = strings["shm"];
+		if (write_shm(output,header,image) == 0){
+			return json_error("cannot write shared memory "+output);
+		}
+	}
+	else{
+		output = strings.count("output") ? strings["output"] : "raster.ppm";
+		ofstream image_file(output,ios::binary);
+		image_file << header;
+		image_file.write(image.data(),image.size());
+		image_file.close();
+		if (image_file.fail()){
+			return json_error("cannot write "+output);
+		}
+	}
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	response << "{\"status\":\"ok\",\"output\":" << json_string(output) << ",\"width\":" << width << ",\"height\":" << height
+	<< ",\"bytes\":" << header.size()+image.size() << ",\"triangles\":" << cache.nb_triangles << ",\"deferred\":" << (deferred ? "true" : "false")
+	<< ",\"seconds\":" << seconds << "}";
+	return response.str();
+}
+
+static string read_request(int client){
+	/**
+	* \brief Lis une demande sur la connexion, jusqu'à la fin de ligne ou la fermeture de la connexion.
+	* \param client connexion du client.
+	*/
+	string request;
+	char buffer[4096];
+	while(request.size() < (1<<20)){
+		ssize_t n = recv(client,buffer,sizeof(buffer),0);
+		if (n <= 0){
+			break;
+		}
+		request.append(buffer,n);
+		if (request.find('\n') != string::npos){
+			request.resize(request.find('\n'));
+			break;
+		}
+	}
+	return request;
+}
+
+static int write_shm(string name, string &header, vector<char> &image){
+	/**
+	* \brief Écrit une image ppm dans une mémoire partagée POSIX (lisible par un autre processus via shm_open).
+	* \param name nom de la mémoire partagée.
+	* \param header entête de l'image.
+	* \param image couleurs des pixels.
+	* \return 1 si l'écriture a réussi, 0 sinon.
+	*/
+	if (name.empty() || name[0] != '/'){
+		name = "/"+name;
+	}
+	size_t size = header.size()+image.size();
+	int fd = shm_open(name.c_str(),O_CREAT|O_RDWR,0644);
+	if (fd < 0){
+		return 0;
+	}
+	if (ftruncate(fd,size) < 0){
+		close(fd);
+		return 0;
+	}
+	char* memory = (char*)mmap(nullptr,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+	close(fd);
+	if (memory == MAP_FAILED){
+		return 0;
+	}
+	memcpy(memory,header.data(),header.size());
+	memcpy(memory+header.size(),image.data(),image.size());
+	munmap(memory,size);
+	return 1;
+}
+
+static string json_error(string message){
+	/**
+	* \brief Renvoie une réponse JSON d'erreur.
+	* \param message description de l'erreur.
+	*/
+	return "{\"status\":\"error\",\"message\":"+json_string(message)+"}";
+}
+
+static string json_string(const string &str){
+	/**
+	* \brief Renvoie une chaîne JSON entre guillemets, avec les guillemets, les barres obliques inversées
+	* et les caractères de contrôle échappés (les textes de la requête sont renvoyés dans les réponses).
+	* \param str texte à écrire.
+	*/
+	string result = "\"";
+	for(char c : str){
+		if (c == '"' || c == '\\'){
+			result += '\\';
+			result += c;
+		}
+		else if ((unsigned char)c < 0x20){
+			char escaped[8];
+			snprintf(escaped,sizeof(escaped),"\\u%04x",(unsigned char)c);
+			result += escaped;
+		}
+		else{
+			result += c;
+		}
+	}
+	return result+"\"";
+}
+
+int read_json(const string &str, map<string,double> &numbers, map<string,string> &strings){
+	/**
+	* \brief Lis un objet JSON plat (sans objet ni tableau imbriqué) : les nombres et booléens (1 ou 0) sont stockés dans numbers,
+	* les chaînes de caractères dans strings.
+	* \param str texte à analyser.
+	* \param numbers dictionnaire des valeurs numériques.
+	* \param strings dictionnaire des chaînes de caractères.
+	* \return 1 si l'objet est valide, 0 sinon.
+	*/
+	size_t i = 0;
+	auto peek = [&](){ //caractère courant, après les espaces
+		while(i < str.size() && isspace((unsigned char)str[i])){
+			i++;
+		}
+		return i < str.size() ? str[i] : '\0';
+	};
+	auto read_string = [&](string &out){
+		if (peek() != '"'){
+			return false;
+		}
+		out.clear();
+		for(i++; i < str.size() && str[i] != '"'; i++){
+			if (str[i] == '\\' && i+1 < str.size()){
+				i++;
+				out += (str[i] == 'n') ? '\n' : (str[i] == 't') ? '\t' : str[i];
+			}
+			else{
+				out += str[i];
+			}
+		}
+		if (i >= str.size()){
+			return false;
+		}
+		i++;
+		return true;
+	};
+
+	if (peek() != '{'){
+		return 0;
+	}
+	i++;
+	if (peek() == '}'){
+		return 1;
+	}
+	while(true){
+		string key,value;
+		if (!read_string(key) || peek() != ':'){
+			return 0;
+		}
+		i++;
+		char c = peek();
+		if (c == '"'){
+			if (!read_string(value)){
+				return 0;
+			}
+			strings[key] = value;
+		}
+		else if (str.compare(i,4,"true") == 0){
+			numbers[key] = 1;
+			i += 4;
+		}
+		else if (str.compare(i,5,"false") == 0){
+			numbers[key] = 0;
+			i += 5;
+		}
+		else if (str.compare(i,4,"null") == 0){
+			i += 4;
+		}
+		else{
+			char* end;
+			double number = strtod(str.c_str()+i,&end);
+			if (end == str.c_str()+i){
+				return 0;
+			}
+			numbers[key] = number;
+			i = end-str.c_str();
+		}
+		c = peek();
+		i++;
+		if (c == '}'){
+			return 1;
+		}
+		if (c != ','){
+			return 0;
+		}
+	}
+}
@@ -0,0 +1,20 @@
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+
+#ifndef SERVER_H
+#define SERVER_H
+
+/**
+* \file server.h
+* \brief Fichier de déclaration du mode serveur : les points et la triangulation restent en mémoire et
+* les rendus sont demandés en JSON sur une socket Unix locale.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int run_server(std::string socket_path, point_cloud &points, std::map<std::string,double> &context);
+int read_json(const std::string &str, std::map<std::string,double> &numbers, std::map<std::string,std::string> &strings);
+
+#endif
@@ -0,0 +1,326 @@
+#include <cstdlib>
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <sstream>
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <math.h>
+#include <limits>
+#include "struct_point.h"
+#include "parallel.h"
+#include "shading.h"
+#include "triangulation.h"
+
+/**
+* \file shading.cpp
+* \brief Fichier d'implémentation des fonctions utilisées pour l'ombrage lisse (normales aux sommets et ombrage multi-directionnel) et les ombres portées.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static void shade_block(const float* __restrict nx, const float* __restrict ny, const float* __restrict nz, float* __restrict shade, size_t n, float lx, float ly, float lz, float weight);
+
+int read_lights(string str, map<string,double> &context){
+	/**
+	* \brief Lis une liste de directions de lumières sous la forme "azimut1,azimut2,..." ou "azimut1:poids1,azimut2:poids2,...".
+	* Les azimuts sont en degrés, comptés dans le sens horaire depuis le nord. Les lumières sont ajoutées à context
+	* (nb_lights, light_azimuth_i, light_weight_i).
+	* \param str texte à analyser.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \return 1 si la liste est valide, 0 sinon.
+	*/
+	istringstream list_stream(str);
+	string item;
+	int nb_lights = 0;
+	while(getline(list_stream,item,',')){
+		size_t sep = item.find(':');
+		try{
+			context["light_azimuth_"+to_string(nb_lights)] = stod(item.substr(0,sep));
+			context["light_weight_"+to_string(nb_lights)] = (sep == string::npos) ? 1 : stod(item.substr(sep+1));
+		}
+		catch(...){
+			return 0;
+		}
+		nb_lights++;
+	}
+	if (nb_lights == 0){
+		return 0;
+	}
+	context["nb_lights"] = nb_lights;
+	return 1;
+}
+
+void set_sun_dir(map<string,double> &context){
+	/**
+	* \brief Calcul la direction de la lumière du soleil (sens de propagation de la lumière) à partir de sa position.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la position du soleil en degrés (sun_azimuth,sun_elevation),
+	* et initialise la direction de la lumière (sun_dir_x,sun_dir_y,sun_dir_z).
+	*/
+	double azimuth = context["sun_azimuth"]*M_PI/180;
+	double elevation = context["sun_elevation"]*M_PI/180;
+	vector<double> sun_dir = {-sin(azimuth)*cos(elevation),-cos(azimuth)*cos(elevation),-sin(elevation)};
+	for(double &c : sun_dir){ //suppression des erreurs d'arrondis des fonctions trigonométriques
+		if (abs(c) < 1e-12){
+			c = 0;
+		}
+	}
+	context["sun_dir_x"] = sun_dir[0];
+	context["sun_dir_y"] = sun_dir[1];
+	context["sun_dir_z"] = sun_dir[2];
+}
+
+void compute_vertex_normals(point_cloud &points, const index_vector &triangles, const vector<char> &kept, vector<float> &vertex_normals, int nb_threads){
+	/**
+	* \brief Calcul les normales aux sommets de la triangulation, pondérées par l'aire des triangles.
+	* Chaque thread accumule les normales d'un bloc de triangles dans son propre tableau, les tableaux sont ensuite sommés et normalisés.
+	* \param points Points de la triangulation.
+	* \param triangles Indices des sommets des triangles sous forme {a0,b0,c0,a1,b1,c1...} (delaunator).
+	* \param kept Booléens indiquant pour chaque triangle s'il est conservé (les triangles trop longs sont ignorés).
+	* \param vertex_normals Vecteur dans lequel stocker les normales sous forme {nx0,ny0,nz0,nx1,...}, orientées vers le haut.
+	* \param nb_threads Nombre de threads à utiliser.
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Computing vertex normals...";
+	time(&t0);
+
+	size_t nb_points = points.size();
+	size_t nb_triangles = triangles.size()/3;
+	vertex_normals.assign(3*nb_points,0);
+	vector<vector<float>> partial_normals(max(0,nb_threads-1)); //tableaux des threads autres que le premier
+
+	//accumulation des normales des faces (le produit vectoriel a une norme égale au double de l'aire, d'où la pondération)
+	parallel_for(nb_triangles,nb_threads,[&](size_t begin, size_t end, int id){
+		vector<float> &normals = (id == 0) ? vertex_normals : partial_normals[id-1];
+		if (id != 0){
+			normals.assign(3*nb_points,0);
+		}
+		for(size_t t = begin; t < end; t++){
+			if (!kept[t]){
+				continue;
+			}
+			size_t i1 = triangles[3*t];
+			size_t i2 = triangles[3*t+1];
+			size_t i3 = triangles[3*t+2];
+			point p1 = points[i1];
+			point p2 = points[i2];
+			point p3 = points[i3];
+			double ux = p2.x-p1.x, uy = p2.y-p1.y, uz = p2.depth-p1.depth;
+			double vx = p3.x-p1.x, vy = p3.y-p1.y, vz = p3.depth-p1.depth;
+			double nx = uy*vz-uz*vy;
+			double ny = uz*vx-ux*vz;
+			double nz = ux*vy-uy*vx;
+			if (nz < 0){ //orientation de la normale vers le haut (profondeurs négatives)
+				nx = -nx;
+				ny = -ny;
+				nz = -nz;
+			}
+			for(size_t i : {i1,i2,i3}){
+				normals[3*i] += nx;
+				normals[3*i+1] += ny;
+				normals[3*i+2] += nz;
+			}
+		}
+	});
+
+	//somme des tableaux des threads et normalisation
+	parallel_for(nb_points,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			for(auto &normals : partial_normals){
+				for(int k = 0; k < 3; k++){
+					vertex_normals[3*i+k] += normals[3*i+k];
+				}
+			}
+			float norm = sqrt(pow(vertex_normals[3*i],2)+pow(vertex_normals[3*i+1],2)+pow(vertex_normals[3*i+2],2));
+			if (norm > 0){
+				for(int k = 0; k < 3; k++){
+					vertex_normals[3*i+k] /= norm;
+				}
+			}
+		}
+	});
+
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'execution
+}
+
+void compute_smooth_illumination(normal_buffer &normals, vector<double> &pixels_illumination, map<string,double> &context){
+	/**
+	* \brief Calcul l'illumination des pixels à partir de leurs normales interpolées et de plusieurs lumières (ombrage multi-directionnel).
+	* L'illumination est la moyenne pondérée des max(0,n.l) de chaque lumière, ramenée entre illu_min et 1.
+	* Les pixels sont traités par blocs dans des boucles sans branchement pour être vectorisées.
+	* \param normals Normales interpolées des pixels.
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de :
+	* - les lumières (nb_lights, light_azimuth_i, light_weight_i, light_elevation)
+	* - le nombre de threads (nb_threads)
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Smooth multi-directional shading...";
+	time(&t0);
+
+	//récupération des lumières sous forme de vecteurs unitaires (x vers l'est, y vers le nord, z vers le haut)
+	int nb_lights = context["nb_lights"];
+	double elevation = context["light_elevation"]*M_PI/180;
+	vector<float> lx,ly,lz,lw;
+	double total_weight = 0;
+	for(int l = 0; l < nb_lights; l++){
+		double azimuth = context["light_azimuth_"+to_string(l)]*M_PI/180;
+		lx.push_back(sin(azimuth)*cos(elevation));
+		ly.push_back(cos(azimuth)*cos(elevation));
+		lz.push_back(sin(elevation));
+		lw.push_back(context["light_weight_"+to_string(l)]);
+		total_weight += lw.back();
+	}
+	if (total_weight <= 0){
+		total_weight = 1;
+	}
+	const float illu_min = 0.5; //illumination minimum voulue (même plage que l'ombrage par face)
+	const float scale = (1-illu_min)/total_weight;
+
+	size_t nb_pixels = pixels_illumination.size();
+	parallel_for(nb_pixels,context["nb_threads"],[&](size_t begin, size_t end, int){
+		const size_t block_size = 4096; //blocs qui tiennent dans le cache
+		float shade[block_size];
+		for(size_t b = begin; b < end; b += block_size){
+			size_t n = min(block_size,end-b);
+			float* __restrict nx = normals.x.data()+b;
+			float* __restrict ny = normals.y.data()+b;
+			float* __restrict nz = normals.z.data()+b;
+
+			//normalisation des normales
+			for(size_t i = 0; i < n; i++){
+				float len2 = nx[i]*nx[i]+ny[i]*ny[i]+nz[i]*nz[i];
+				float inv = len2 > 0 ? 1/sqrt(len2) : 0;
+				nx[i] *= inv;
+				ny[i] *= inv;
+				nz[i] *= inv;
+				shade[i] = 0;
+			}
+
+			//accumulation de chaque lumière
+			for(int l = 0; l < nb_lights; l++){
+				shade_block(nx,ny,nz,shade,n,lx[l],ly[l],lz[l],lw[l]);
+			}
+
+			//ajustement de l'illumination, les pixels sans normale gardent leur illumination (totale pour les pixels non colorés)
+			double* illumination = pixels_illumination.data()+b;
+			for(size_t i = 0; i < n; i++){
+				illumination[i] = nz[i] != 0 ? illu_min+shade[i]*scale : illumination[i];
+			}
+		}
+	});
+
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'execution
+}
+
+void compute_cast_shadows(vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context){
+	/**
+	* \brief Calcul les ombres portées par le relief en parcourant l'image selon des lignes parallèles à la direction du soleil.
+	* Chaque ligne est parcourue dans le sens de propagation de la lumière en gardant l'horizon courant :
+	* le pixel p est à l'ombre si un pixel q déjà parcouru vérifie h_q + s_q*tan(e) > h_p + s_p*tan(e),
+	* avec s l'abscisse le long de la ligne et e l'élévation du soleil. Le coût est linéaire par ligne et les lignes sont traitées en parallèle.
+	* L'illumination des pixels à l'ombre est multipliée par shadow_factor.
+	* \param pixels Liste des pixels (indices de couleur, convertis en profondeur).
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de :
+	* - la direction du soleil (sun_dir_x,sun_dir_y,sun_dir_z)
+	* - nombre de pixels et dimensions des pixels (width,height,lg_pix,h_pix)
+	* - couleur par défaut des pixels (default_color), facteur d'assombrissement (shadow_factor)
+	* - le nombre de threads (nb_threads)
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Computing cast shadows...";
+	time(&t0);
+
+	int width = context["width"];
+	int height = context["height"];
+	double lg_pix = context["lg_pix"];
+	double h_pix = context["h_pix"];
+	int default_color = context["default_color"];
+	double shadow_factor = context["shadow_factor"];
+	double dx = context["sun_dir_x"];
+	double dy = context["sun_dir_y"];
+	double horizontal = sqrt(pow(dx,2)+pow(dy,2));
+	if (horizontal == 0 || -context["sun_dir_z"] <= 0){ //soleil au zénith ou sous l'horizon : pas d'ombre calculable
+		cout << " ignored (sun at zenith or below horizon)" << endl;
+		return;
+	}
+	double tan_elevation = -context["sun_dir_z"]/horizontal;
+
+	//direction de propagation en pixels (les lignes de l'image vont du nord au sud)
+	double dc = dx/lg_pix;
+	double dr = -dy/h_pix;
+
+	//axe principal du parcours (celui où la direction avance le plus vite), les pas se font d'un pixel sur cet axe
+	bool x_major = abs(dc) >= abs(dr);
+	int lg_major = x_major ? width : height;
+	int lg_minor = x_major ? height : width;
+	int step = ((x_major ? dc : dr) > 0) ? 1 : -1; //sens de parcours sur l'axe principal
+	double slope = (x_major ? dr/abs(dc) : dc/abs(dr)); //décalage sur l'axe secondaire pour un pas
+	double step_lg = x_major ? sqrt(pow(lg_pix,2)+pow(slope*h_pix,2)) : sqrt(pow(h_pix,2)+pow(slope*lg_pix,2)); //longueur d'un pas en m
+
+	//décalages entiers sur l'axe secondaire le long d'une ligne, communs à toutes les lignes
+	vector<int> offsets(lg_major);
+	for(int t = 0; t < lg_major; t++){
+		offsets[t] = lround(t*slope);
+	}
+	int min_offset = min(offsets.front(),offsets.back());
+	int max_offset = max(offsets.front(),offsets.back());
+	int nb_lines = lg_minor+max_offset-min_offset; //lignes qui couvrent chaque pixel exactement une fois
+
+	parallel_for(nb_lines,context["nb_threads"],[&](size_t begin, size_t end, int){
+		for(size_t l = begin; l < end; l++){
+			int start = int(l)-max_offset; //position de la ligne sur l'axe secondaire au début du parcours
+			double horizon = -numeric_limits<double>::infinity();
+			for(int t = 0; t < lg_major; t++){
+				int minor = start+offsets[t];
+				if (minor < 0 || minor >= lg_minor){
+					continue;
+				}
+				int major = (step > 0) ? t : lg_major-1-t;
+				size_t index = x_major ? size_t(minor)*width+major : size_t(major)*width+minor;
+				if (pixels[index] == default_color){ //pixel sans profondeur
+					continue;
+				}
+				double level = convert_to_depth(pixels[index])+t*step_lg*tan_elevation;
+				if (horizon > level){
+					pixels_illumination[index] *= shadow_factor;
+				}
+				else{
+					horizon = level;
+				}
+			}
+		}
+	});
+
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'execution
+}
+
+static void shade_block(const float* __restrict nx, const float* __restrict ny, const float* __restrict nz, float* __restrict shade, size_t n, float lx, float ly, float lz, float weight){
+	/**
+	* \brief Ajoute la contribution d'une lumière à l'ombrage d'un bloc de pixels (boucle vectorisée).
+	* \param nx,ny,nz normales unitaires des pixels.
+	* \param shade ombrage accumulé des pixels.
+	* \param n nombre de pixels du bloc.
+	* \param lx,ly,lz direction unitaire vers la lumière.
+	* \param weight poids de la lumière.
+	*/
+	for(size_t i = 0; i < n; i++){
+		float d = nx[i]*lx+ny[i]*ly+nz[i]*lz;
+		shade[i] += weight*(d > 0 ? d : 0);
+	}
+}
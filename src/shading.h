@@ -0,0 +1,34 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+
+#ifndef SHADING_H
+#define SHADING_H
+
+/**
+* \file shading.h
+* \brief Fichier de déclaration des fonctions utilisées pour l'ombrage lisse (normales aux sommets et ombrage multi-directionnel) et les ombres portées.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+struct normal_buffer
+{
+	/**
+	* \brief Normales interpolées des pixels, stockées en tableaux séparés pour que le calcul de l'ombrage soit vectorisé.
+	* \param x composantes x des normales {nx_pixel1,nx_pixel2,...}.
+	* \param y composantes y des normales.
+	* \param z composantes z des normales (nulles pour les pixels non colorés).
+	*/
+	std::vector<float> x, y, z;
+};
+
+int read_lights(std::string str, std::map<std::string,double> &context);
+void set_sun_dir(std::map<std::string,double> &context);
+void compute_vertex_normals(point_cloud &points, const index_vector &triangles, const std::vector<char> &kept, std::vector<float> &vertex_normals, int nb_threads);
+void compute_smooth_illumination(normal_buffer &normals, std::vector<double> &pixels_illumination, std::map<std::string,double> &context);
+void compute_cast_shadows(std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context);
+
+#endif
@@ -0,0 +1,568 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <math.h>
+#include "struct_point.h"
+#include "triangulation.h"
+#include "parallel.h"
+#include "simplification.h"
+
+/**
+* \file simplification.cpp
+* \brief Fichier d'implémentation de la simplification de la triangulation (contraction d'arêtes selon l'erreur quadrique)
+* et des niveaux de détail utilisés pour les rendus de petite taille.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+const size_t max_valence = 12; //nombre maximal de voisins d'un sommet après une contraction
+
+typedef array<double,10> quadric; //matrice 4x4 symétrique {xx,xy,xz,xw,yy,yz,yw,zz,zw,ww}
+
+struct collapse_mesh
+{
+	/**
+	* \brief Triangulation en cours de simplification.
+	* \param points copie des points du relevé triée selon une courbe de Morton, pour que les voisins soient proches en mémoire
+	* (les sommets ne sont jamais déplacés).
+	* \param origin_x,origin_y origine des coordonnées locales (précision des quadriques).
+	* \param triangles sommets des triangles conservés de la triangulation.
+	* \param triangle_alive booléens des triangles non supprimés.
+	* \param vertex_triangles triangles de chaque sommet (les triangles supprimés sont retirés au fur et à mesure).
+	* \param triangle_points points supprimés situés dans chaque triangle, pour borner l'écart vertical.
+	* \param quadrics erreur quadrique (distance verticale aux plans des triangles) de chaque sommet.
+	* \param vertex_alive,locked sommets non supprimés, sommets du bord qui ne sont jamais supprimés.
+	* \param nb_alive nombre de sommets non supprimés.
+	* \param max_error plus grand écart vertical mesuré en m.
+	*/
+	point_cloud points;
+	double origin_x = 0, origin_y = 0;
+	vector<array<uint32_t,3>> triangles;
+	vector<char> triangle_alive;
+	vector<vector<uint32_t>> vertex_triangles;
+	vector<vector<uint32_t>> triangle_points;
+	vector<quadric> quadrics;
+	vector<char> vertex_alive, locked;
+	size_t nb_alive = 0;
+	double max_error = 0;
+};
+
+struct collapse_candidate
+{
+	/**
+	* \brief Contraction du sommet u sur son voisin v, de coût cost (erreur quadrique).
+	*/
+	double cost;
+	uint32_t u, v;
+};
+
+static void init_mesh(point_cloud &points, tin &t, map<string,double> &context, collapse_mesh &m);
+static void best_candidate(collapse_mesh &m, uint32_t u, collapse_candidate &candidate);
+static bool try_collapse(collapse_mesh &m, uint32_t u, uint32_t v, double bound, double &error);
+static bool claim_region(collapse_mesh &m, uint32_t u, uint32_t v, vector<char> &claimed);
+static void save_level(collapse_mesh &m, lod_level &level);
+
+static double area2(const point &a, const point &b, const point &c){
+	/**
+	* \brief Double de l'aire signée du triangle (a,b,c) dans le plan (x,y).
+	*/
+	return (b.x-a.x)*(c.y-a.y)-(c.x-a.x)*(b.y-a.y);
+}
+
+static double quadric_error(const quadric &q, double x, double y, double z){
+	/**
+	* \brief Evalue l'erreur quadrique v^T Q v au point v = (x,y,z,1).
+	*/
+	return q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x + q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y + q[7]*z*z + 2*q[8]*z + q[9];
+}
+
+void build_lods(point_cloud &points, tin &t, map<string,double> &context, vector<lod_level> &lods, double max_edge_lg){
+	/**
+	* \brief Construit des niveaux de détail de la triangulation par contractions successives d'arêtes.
+	* Une contraction supprime un sommet u en le remplaçant par un voisin v (les sommets restent des points du relevé).
+	* Elles sont faites par tours : le meilleur voisin de chaque sommet est calculé selon l'erreur quadrique (distance verticale
+	* aux plans des triangles), puis les moins coûteuses dont les voisinages sont disjoints sont faites en parallèle.
+	* Chaque point supprimé reste rattaché au triangle qui le contient, une contraction est refusée si l'écart vertical
+	* entre ces points et les nouveaux triangles dépasse la borne du niveau, si un triangle se retourne ou si la triangulation
+	* ne reste pas une surface. Les sommets du bord (enveloppe et triangles trop longs) sont conservés, le contour ne change pas.
+	* Chaque niveau a environ 4 fois moins de sommets que le précédent et une borne d'erreur 2 fois plus grande.
+	* \param points Points de la triangulation.
+	* \param t Triangulation complète (seuls les triangles conservés sont simplifiés).
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de :
+	* - la borne d'erreur verticale du premier niveau en m (lod_error, 1/256 de l'écart de profondeur si 0)
+	* - les profondeurs limites (min_depth,max_depth) et le nombre de threads (nb_threads)
+	* \param lods Vecteur dans lequel stocker les niveaux, du plus fin au plus grossier.
+	* \param max_edge_lg Longueur moyenne des cotés à partir de laquelle il n'est plus utile de simplifier.
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Building levels of detail...";
+	time(&t0);
+
+	collapse_mesh m;
+	init_mesh(points,t,context,m);
+	double bound = context["lod_error"];
+	if (bound <= 0){
+		bound = abs(context["max_depth"]-context["min_depth"])/256;
+	}
+	int nb_threads = max(1,int(context["nb_threads"]));
+	size_t nb_vertices = points.size();
+	size_t previous = m.nb_alive;
+	int unchanged = 0;
+
+	//meilleure contraction de chaque sommet, recalculée uniquement si son voisinage a changé
+	vector<collapse_candidate> best(nb_vertices);
+	vector<char> dirty(nb_vertices,1);
+	vector<char> claimed(nb_vertices,0);
+
+	for(int iteration = 0; iteration < 16 && unchanged < 3; iteration++){
+		size_t target = previous/4;
+		size_t before = m.nb_alive;
+		fill(dirty.begin(),dirty.end(),1); //nouvelle borne : les contractions refusées peuvent devenir valides
+
+		//contractions par tours : à chaque tour, contractions indépendantes les moins coûteuses faites en parallèle
+		while(m.nb_alive > target){
+
+			//meilleur voisin des sommets modifiés (calculés en parallèle)
+			parallel_for(nb_vertices,nb_threads,[&](size_t begin, size_t end, int){
+				for(size_t u = begin; u < end; u++){
+					if (dirty[u]){
+						best_candidate(m,u,best[u]);
+						dirty[u] = 0;
+					}
+				}
+			});
+
+			//le seizième le moins coûteux des contractions possibles, par coût croissant
+			vector<uint32_t> round;
+			for(size_t u = 0; u < nb_vertices; u++){
+				if (m.vertex_alive[u] && best[u].cost < numeric_limits<double>::max()){
+					round.push_back(u);
+				}
+			}
+			auto cheaper = [&](uint32_t a, uint32_t b){ return best[a].cost < best[b].cost || (best[a].cost == best[b].cost && a < b); };
+			size_t nb_round = min(round.size(),max<size_t>(round.size()/16,1024));
+			nth_element(round.begin(),round.begin()+nb_round-(nb_round > 0),round.end(),cheaper);
+			round.resize(nb_round);
+			sort(round.begin(),round.end(),cheaper);
+
+			//sélection des contractions dont les voisinages sont disjoints
+			vector<collapse_candidate> selected;
+			size_t nb_wanted = m.nb_alive-target;
+			for(size_t k = 0; k < round.size() && selected.size() < nb_wanted; k++){
+				if (claim_region(m,best[round[k]].u,best[round[k]].v,claimed)){
+					selected.push_back(best[round[k]]);
+				}
+			}
+			fill(claimed.begin(),claimed.end(),0);
+
+			//contractions en parallèle, les voisins qui visaient u ou v devront recalculer leur meilleure contraction
+			atomic<size_t> nb_collapsed(0);
+			vector<double> thread_error(nb_threads,0);
+			parallel_for(selected.size(),nb_threads,[&](size_t begin, size_t end, int thread_id){
+				for(size_t k = begin; k < end; k++){
+					uint32_t u = selected[k].u, v = selected[k].v;
+					double error = 0;
+					if (try_collapse(m,u,v,bound,error)){
+						nb_collapsed++;
+						thread_error[thread_id] = max(thread_error[thread_id],error);
+						dirty[v] = 1;
+						for(uint32_t tri : m.vertex_triangles[v]){
+							for(uint32_t w : m.triangles[tri]){
+								dirty[w] = dirty[w] || best[w].v == u || best[w].v == v;
+							}
+						}
+					}
+					else{ //refusée : plus de candidat pour u tant que son voisinage ne change pas
+						best[u].cost = numeric_limits<double>::max();
+					}
+				}
+			});
+			m.nb_alive -= nb_collapsed;
+			for(double error : thread_error){
+				m.max_error = max(m.max_error,error);
+			}
+			if (selected.empty()){ //plus aucune contraction possible avec cette borne
+				break;
+			}
+		}
+		unchanged = (m.nb_alive == before) ? unchanged+1 : 0;
+
+		//nouveau niveau si le nombre de sommets a suffisamment diminué
+		if (m.nb_alive <= 0.8*previous){
+			lods.emplace_back();
+			save_level(m,lods.back());
+			previous = m.nb_alive;
+			if (lods.back().edge_lg >= max_edge_lg){
+				break;
+			}
+		}
+		bound *= 2;
+	}
+
+	time(&tf);
+	cout << " " << lods.size() << " levels";
+	for(auto &level : lods){
+		cout << ", " << level.points.size() << " vertices (error " << level.max_error << " m)";
+	}
+	cout << " (" << tf-t0 << " s)" << endl; //affichage du temps d'execution
+}
+
+lod_level* select_lod(vector<lod_level> &lods, double pixel_size){
+	/**
+	* \brief Choisit le niveau le plus grossier dont les triangles restent plus petits qu'un pixel.
+	* \param lods Niveaux de détail, du plus fin au plus grossier.
+	* \param pixel_size Taille d'un pixel du rendu en m.
+	* \return Niveau choisi, nullptr si la triangulation complète doit être utilisée.
+	*/
+	lod_level* chosen = nullptr;
+	for(auto &level : lods){
+		if (level.edge_lg <= pixel_size){
+			chosen = &level;
+		}
+	}
+	return chosen;
+}
+
+static void init_mesh(point_cloud &points, tin &t, map<string,double> &context, collapse_mesh &m){
+	/**
+	* \brief Prépare la simplification : triangles conservés, adjacences, sommets du bord et quadriques.
+	* Un sommet est au bord si une de ses demi-arêtes n'a pas d'opposée ou si l'opposée est dans un triangle non conservé.
+	*/
+	size_t nb_vertices = points.size();
+	int nb_threads = max(1,int(context["nb_threads"]));
+	m.origin_x = context["min_x"];
+	m.origin_y = context["min_y"];
+
+	//renumérotation des sommets selon une courbe de Morton (code sur une grille de 2^16 x 2^16 cases)
+	double scale_x = 65535/max(context["max_x"]-m.origin_x,1e-9);
+	double scale_y = 65535/max(context["max_y"]-m.origin_y,1e-9);
+	vector<uint64_t> codes(nb_vertices);
+	parallel_for(nb_vertices,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			uint64_t cx = uint64_t(min(65535.0,max(0.0,(points.x(i)-m.origin_x)*scale_x)));
+			uint64_t cy = uint64_t(min(65535.0,max(0.0,(points.y(i)-m.origin_y)*scale_y)));
+			uint64_t code = 0;
+			for(int b = 0; b < 16; b++){
+				code |= ((cx>>b)&1)<<(2*b) | ((cy>>b)&1)<<(2*b+1);
+			}
+			codes[i] = (code<<32) | i;
+		}
+	});
+	sort(codes.begin(),codes.end());
+	vector<uint32_t> rank(nb_vertices);
+	m.points.resize(nb_vertices);
+	for(size_t k = 0; k < nb_vertices; k++){
+		uint32_t i = codes[k] & 0xFFFFFFFF;
+		rank[i] = k;
+		m.points.set(k,points[i]);
+	}
+	vector<uint64_t>().swap(codes);
+
+	//triangles conservés, triés selon leur premier sommet
+	m.vertex_alive.assign(nb_vertices,0);
+	m.locked.assign(nb_vertices,0);
+	m.vertex_triangles.assign(nb_vertices,{});
+	for(size_t i = 0; i < t.kept.size(); i++){
+		if (!t.kept[i]){
+			continue;
+		}
+		m.triangles.push_back({rank[t.triangles[3*i]],rank[t.triangles[3*i+1]],rank[t.triangles[3*i+2]]});
+		for(size_t e = 3*i; e < 3*i+3; e++){
+			tin_index opposite = t.halfedges[e];
+			size_t next = (e%3 == 2) ? e-2 : e+1;
+			if (opposite == no_halfedge || !t.kept[opposite/3]){
+				m.locked[rank[t.triangles[e]]] = 1;
+				m.locked[rank[t.triangles[next]]] = 1;
+			}
+		}
+	}
+	sort(m.triangles.begin(),m.triangles.end(),[](const array<uint32_t,3> &a, const array<uint32_t,3> &b){
+		return min({a[0],a[1],a[2]}) < min({b[0],b[1],b[2]});
+	});
+	for(uint32_t tri = 0; tri < m.triangles.size(); tri++){
+		for(uint32_t v : m.triangles[tri]){
+			m.vertex_triangles[v].push_back(tri);
+		}
+	}
+	m.triangle_alive.assign(m.triangles.size(),1);
+	m.triangle_points.assign(m.triangles.size(),{});
+	for(size_t v = 0; v < nb_vertices; v++){
+		if (!m.vertex_triangles[v].empty()){
+			m.vertex_alive[v] = 1;
+			m.nb_alive++;
+		}
+	}
+
+	//plan vertical de chaque triangle z = a*x+b*y+c, soit l'erreur a*x+b*y-z+c pondérée par l'aire
+	vector<array<double,5>> planes(m.triangles.size());
+	parallel_for(m.triangles.size(),nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			point p1 = m.points[m.triangles[i][0]];
+			point p2 = m.points[m.triangles[i][1]];
+			point p3 = m.points[m.triangles[i][2]];
+			double x1 = p1.x-m.origin_x, y1 = p1.y-m.origin_y;
+			double ux = p2.x-p1.x, uy = p2.y-p1.y, uz = p2.depth-p1.depth;
+			double vx = p3.x-p1.x, vy = p3.y-p1.y, vz = p3.depth-p1.depth;
+			double nx = uy*vz-uz*vy, ny = uz*vx-ux*vz, nz = ux*vy-uy*vx;
+			if (nz == 0){ //triangle dégénéré
+				planes[i] = {0,0,0,0,0};
+				continue;
+			}
+			double a = -nx/nz, b = -ny/nz;
+			planes[i] = {a,b,-1,p1.depth-a*x1-b*y1,abs(nz)/2};
+		}
+	});
+
+	//quadrique de chaque sommet : somme des quadriques de ses triangles
+	m.quadrics.assign(nb_vertices,{});
+	parallel_for(nb_vertices,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t v = begin; v < end; v++){
+			quadric &q = m.quadrics[v];
+			for(uint32_t tri : m.vertex_triangles[v]){
+				array<double,5> &p = planes[tri];
+				double w = p[4];
+				q[0] += w*p[0]*p[0]; q[1] += w*p[0]*p[1]; q[2] += w*p[0]*p[2]; q[3] += w*p[0]*p[3];
+				q[4] += w*p[1]*p[1]; q[5] += w*p[1]*p[2]; q[6] += w*p[1]*p[3];
+				q[7] += w*p[2]*p[2]; q[8] += w*p[2]*p[3];
+				q[9] += w*p[3]*p[3];
+			}
+		}
+	});
+}
+
+static void best_candidate(collapse_mesh &m, uint32_t u, collapse_candidate &candidate){
+	/**
+	* \brief Cherche le voisin sur lequel contracter le sommet u au moindre coût (erreur quadrique au voisin).
+	* Coût infini pour un sommet supprimé ou du bord.
+	*/
+	point_cloud &points = m.points;
+	candidate = {numeric_limits<double>::max(),u,u};
+	if (!m.vertex_alive[u] || m.locked[u]){
+		return;
+	}
+	for(uint32_t tri : m.vertex_triangles[u]){
+		for(uint32_t v : m.triangles[tri]){
+			if (v == u){
+				continue;
+			}
+			double x = points[v].x-m.origin_x, y = points[v].y-m.origin_y;
+			double cost = quadric_error(m.quadrics[u],x,y,points[v].depth)+quadric_error(m.quadrics[v],x,y,points[v].depth);
+			if (cost < candidate.cost || (cost == candidate.cost && v < candidate.v)){
+				candidate = {cost,u,v};
+			}
+		}
+	}
+}
+
+static bool claim_region(collapse_mesh &m, uint32_t u, uint32_t v, vector<char> &claimed){
+	/**
+	* \brief Réserve les sommets voisins de u et de v pour la contraction (u,v) si aucun n'est déjà réservé,
+	* les contractions réservées d'un même tour ne partagent ainsi aucun sommet ni triangle.
+	* \return true si la zone a été réservée.
+	*/
+	for(uint32_t w : {u,v}){
+		for(uint32_t tri : m.vertex_triangles[w]){
+			for(uint32_t x : m.triangles[tri]){
+				if (claimed[x]){
+					return false;
+				}
+			}
+		}
+	}
+	for(uint32_t w : {u,v}){
+		for(uint32_t tri : m.vertex_triangles[w]){
+			for(uint32_t x : m.triangles[tri]){
+				claimed[x] = 1;
+			}
+		}
+	}
+	return true;
+}
+
+static bool try_collapse(collapse_mesh &m, uint32_t u, uint32_t v, double bound, double &error){
+	/**
+	* \brief Contracte le sommet u sur son voisin v si la triangulation reste valide et si l'écart vertical reste sous la borne.
+	* Seuls les sommets voisins de u et de v (et leurs triangles) sont lus ou modifiés.
+	* \param error écart vertical maximal des points de la zone après la contraction.
+	* \return true si la contraction a été faite.
+	*/
+	point_cloud &points = m.points;
+
+	//triangles autour de u : ceux de l'arête (u,v) disparaissent, u est remplacé par v dans les autres
+	thread_local vector<uint32_t> removed, moved, u_neighbours, v_neighbours, common, region, location;
+	thread_local vector<array<uint32_t,3>> new_corners;
+	removed.clear();
+	moved.clear();
+	for(uint32_t tri : m.vertex_triangles[u]){
+		auto &corners = m.triangles[tri];
+		if (corners[0] == v || corners[1] == v || corners[2] == v){
+			removed.push_back(tri);
+		}
+		else{
+			moved.push_back(tri);
+		}
+	}
+	if (removed.size() != 2 || moved.empty()){ //arête du bord ou configuration dégénérée
+		return false;
+	}
+
+	//les seuls voisins communs de u et v doivent être les sommets opposés à l'arête (la surface reste une variété)
+	u_neighbours.clear();
+	v_neighbours.clear();
+	for(uint32_t tri : m.vertex_triangles[u]){
+		for(uint32_t w : m.triangles[tri]){
+			u_neighbours.push_back(w);
+		}
+	}
+	for(uint32_t tri : m.vertex_triangles[v]){
+		for(uint32_t w : m.triangles[tri]){
+			v_neighbours.push_back(w);
+		}
+	}
+	sort(u_neighbours.begin(),u_neighbours.end());
+	u_neighbours.erase(unique(u_neighbours.begin(),u_neighbours.end()),u_neighbours.end());
+	sort(v_neighbours.begin(),v_neighbours.end());
+	v_neighbours.erase(unique(v_neighbours.begin(),v_neighbours.end()),v_neighbours.end());
+	common.clear();
+	set_intersection(u_neighbours.begin(),u_neighbours.end(),v_neighbours.begin(),v_neighbours.end(),back_inserter(common));
+	if (common.size() != 4){ //u, v et les deux sommets opposés
+		return false;
+	}
+
+	//nombre de voisins de v limité, pour éviter les éventails de triangles très allongés
+	if (u_neighbours.size()+v_neighbours.size()-common.size()-2 > max_valence){
+		return false;
+	}
+
+	//aucun triangle ne doit se retourner ou devenir plat
+	new_corners.resize(moved.size());
+	for(size_t i = 0; i < moved.size(); i++){
+		auto corners = m.triangles[moved[i]];
+		double before = area2(points[corners[0]],points[corners[1]],points[corners[2]]);
+		for(auto &c : corners){
+			c = (c == u) ? v : c;
+		}
+		double after = area2(points[corners[0]],points[corners[1]],points[corners[2]]);
+		if (after*before <= 0 || abs(after) < 1e-9*abs(before)){
+			return false;
+		}
+		new_corners[i] = corners;
+	}
+
+	//écart vertical des points supprimés de la zone (et de u) aux nouveaux triangles
+	region.assign(1,u);
+	for(uint32_t tri : m.vertex_triangles[u]){
+		region.insert(region.end(),m.triangle_points[tri].begin(),m.triangle_points[tri].end());
+	}
+	location.resize(region.size());
+	double max_error = 0;
+	for(size_t k = 0; k < region.size(); k++){
+		point q = points[region[k]];
+		double best = -numeric_limits<double>::max();
+		double depth = q.depth;
+		for(size_t i = 0; i < moved.size(); i++){
+			point a = points[new_corners[i][0]];
+			point b = points[new_corners[i][1]];
+			point c = points[new_corners[i][2]];
+			double total = area2(a,b,c);
+			double wa = area2(q,b,c)/total, wb = area2(a,q,c)/total, wc = 1-wa-wb;
+			double inside = min({wa,wb,wc}); //positif si q est dans le triangle
+			if (inside > best){
+				best = inside;
+				location[k] = i;
+				depth = wa*a.depth+wb*b.depth+wc*c.depth;
+			}
+		}
+		max_error = max(max_error,abs(depth-q.depth));
+		if (max_error > bound){
+			return false;
+		}
+	}
+
+	//application de la contraction
+	for(uint32_t tri : removed){
+		m.triangle_alive[tri] = 0;
+	}
+	for(uint32_t tri : m.vertex_triangles[u]){
+		vector<uint32_t>().swap(m.triangle_points[tri]);
+	}
+	for(size_t i = 0; i < moved.size(); i++){
+		m.triangles[moved[i]] = new_corners[i];
+		m.vertex_triangles[v].push_back(moved[i]);
+	}
+	for(size_t k = 0; k < region.size(); k++){
+		m.triangle_points[moved[location[k]]].push_back(region[k]);
+	}
+	for(uint32_t w : common){ //retrait des triangles supprimés des listes de v et des sommets opposés
+		auto &list = m.vertex_triangles[w];
+		list.erase(remove_if(list.begin(),list.end(),[&](uint32_t tri){ return !m.triangle_alive[tri]; }),list.end());
+	}
+	vector<uint32_t>().swap(m.vertex_triangles[u]);
+	for(int k = 0; k < 10; k++){
+		m.quadrics[v][k] += m.quadrics[u][k];
+	}
+	m.vertex_alive[u] = 0;
+	error = max_error;
+	return true;
+}
+
+static void save_level(collapse_mesh &m, lod_level &level){
+	/**
+	* \brief Copie l'état courant de la simplification dans un niveau de détail (sommets renumérotés, demi-arêtes recalculées).
+	*/
+	point_cloud &points = m.points;
+	vector<uint32_t> remap(points.size(),numeric_limits<uint32_t>::max());
+	for(size_t tri = 0; tri < m.triangles.size(); tri++){
+		if (!m.triangle_alive[tri]){
+			continue;
+		}
+		for(uint32_t v : m.triangles[tri]){
+			if (remap[v] == numeric_limits<uint32_t>::max()){
+				remap[v] = level.points.size();
+				level.points.push_back(points[v]);
+			}
+			level.t.triangles.push_back(remap[v]);
+		}
+	}
+	size_t nb_halfedges = level.t.triangles.size();
+	level.t.kept.assign(nb_halfedges/3,1);
+
+	//demi-arêtes opposées : l'arête (a,b) d'un triangle est l'opposée de l'arête (b,a) du triangle voisin
+	unordered_map<uint64_t,size_t> edges;
+	edges.reserve(nb_halfedges);
+	for(size_t e = 0; e < nb_halfedges; e++){
+		size_t next = (e%3 == 2) ? e-2 : e+1;
+		edges[(uint64_t(level.t.triangles[e])<<32) | level.t.triangles[next]] = e;
+	}
+	level.t.halfedges.assign(nb_halfedges,no_halfedge);
+	double sum_lg = 0, max_lg = 0;
+	for(size_t e = 0; e < nb_halfedges; e++){
+		size_t next = (e%3 == 2) ? e-2 : e+1;
+		auto found = edges.find((uint64_t(level.t.triangles[next])<<32) | level.t.triangles[e]);
+		if (found != edges.end()){
+			level.t.halfedges[e] = found->second;
+		}
+		point a = level.points[level.t.triangles[e]];
+		point b = level.points[level.t.triangles[next]];
+		double lg = sqrt(pow(b.x-a.x,2)+pow(b.y-a.y,2));
+		sum_lg += lg;
+		max_lg = max(max_lg,lg);
+	}
+	level.edge_lg = sum_lg/max<size_t>(nb_halfedges,1);
+	level.t.lim_triangle_lg = max_lg;
+	level.max_error = m.max_error;
+}
@@ -0,0 +1,39 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+
+#ifndef SIMPLIFICATION_H
+#define SIMPLIFICATION_H
+
+/**
+* \file simplification.h
+* \brief Fichier de déclaration de la simplification de la triangulation (contraction d'arêtes selon l'erreur quadrique)
+* et des niveaux de détail utilisés pour les rendus de petite taille.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+struct lod_level
+{
+	/**
+	* \brief Niveau de détail : triangulation simplifiée dont les sommets sont des points du relevé.
+	* \param points sommets conservés du niveau.
+	* \param t triangulation du niveau (tous les triangles sont conservés, demi-arêtes recalculées).
+	* \param grid index spatial des triangles (rendus d'une fenêtre, voir server.cpp).
+	* \param edge_lg longueur moyenne des cotés des triangles en m.
+	* \param max_error écart vertical maximal en m entre le niveau et les points supprimés.
+	*/
+	point_cloud points;
+	tin t;
+	triangle_grid grid;
+	double edge_lg = 0;
+	double max_error = 0;
+};
+
+void build_lods(point_cloud &points, tin &t, std::map<std::string,double> &context, std::vector<lod_level> &lods, double max_edge_lg);
+lod_level* select_lod(std::vector<lod_level> &lods, double pixel_size);
+
+#endif
@@ -0,0 +1,256 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include "parallel.h"
+#include "generate_image.h"
+#include "sparse.h"
+
+/**
+* \file sparse.cpp
+* \brief Fichier d'implémentation du rendu par tuiles creuses, pour les relevés non convexes dont la plupart des pixels
+* du rectangle englobant restent à la couleur par défaut.
+* L'image est découpée en tuiles de sparse_tile pixels de coté. Les rectangles englobants des triangles conservés marquent
+* les tuiles occupées, seules représentées : chacune est rendue comme une fenêtre de l'image (voir select_triangles)
+* et écrite à sa place dans le fichier. Les tuiles vides ne sont ni allouées ni rendues : si la couleur par défaut est
+* le noir, elles restent des trous du fichier créé à sa taille finale (lus comme des zéros, sans écriture), sinon
+* leurs lignes sont remplies par copie d'une ligne de la couleur par défaut.
+* La mémoire et le temps d'écriture dépendent ainsi de la surface couverte et non du rectangle englobant.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static void mark_tiles(point_cloud &points, tin &t, map<string,double> &context, int tile_size, vector<char> &occupied);
+static void render_tile(point_cloud &points, tin &t, triangle_grid &grid, map<string,double> &context, int c0, int c1, int r0, int r1, vector<char> &image);
+
+bool use_sparse(map<string,double> &context, pixel_channels *channels){
+	/**
+	* \brief Indique si l'image est rendue par tuiles creuses : tuiles de sparse_tile pixels (0 = image entière),
+	* sauf avec les ombres portées (elles traversent les tuiles vides) et les canaux de l'image entière (modèle numérique
+	* de terrain, pente..., rangés ligne par ligne de l'image).
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param channels Canaux des pixels demandés, ignorés si nullptr.
+	* \return booléen.
+	*/
+	if (context["sparse_tile"] <= 0){
+		return false;
+	}
+	if (context["shadows"] == 1){
+		cout << "- Cast shadows need the whole image, sparse rendering disabled" << endl;
+		return false;
+	}
+	if (channels != nullptr && (channels->depth || channels->slope || channels->aspect || channels->rugosity || channels->triangle)){
+		cout << "- Raster channels need the whole image, sparse rendering disabled" << endl;
+		return false;
+	}
+	return true;
+}
+
+int render_sparse(point_cloud &points, tin &t, map<string,double> &context, string image_name){
+	/**
+	* \brief Rend la triangulation tuile par tuile, seulement là où il y a des triangles, et écrit l'image (voir sparse.cpp).
+	* \param points Points de la triangulation.
+	* \param t Triangulation à rendre.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de la taille de l'image et des pixels (width,height,lg_pix,h_pix), de ses limites,
+	* de la taille des tuiles (sparse_tile), de la couleur par défaut (default_color) et des paramètres du rendu (voir color_triangles).
+	* \param image_name nom de l'image à générer.
+	* \return 1 si l'image a été écrite, 0 sinon.
+	*/
+	auto start = chrono::steady_clock::now();
+	int width = context["width"];
+	int height = context["height"];
+	int tile_size = max(1,int(context["sparse_tile"]));
+	int nb_tiles_x = (width+tile_size-1)/tile_size;
+	int nb_tiles_y = (height+tile_size-1)/tile_size;
+
+	//tuiles occupées
+	vector<char> occupied;
+	mark_tiles(points,t,context,tile_size,occupied);
+	size_t nb_occupied = count(occupied.begin(),occupied.end(),1);
+	cout << "- Sparse raster : " << nb_occupied << "/" << occupied.size() << " tiles of " << tile_size << " pixels touched by triangles" << endl;
+
+	//couleur par défaut, les tuiles vides sont des trous du fichier si elle est noire
+	vector<int> default_pixel(1,context["default_color"]);
+	vector<double> default_illumination(1,1);
+	char default_rgb[3];
+	colorize_band(default_pixel,default_illumination,context,default_rgb); //(Voir generate_image.cpp)
+	bool black = default_rgb[0] == 0 && default_rgb[1] == 0 && default_rgb[2] == 0;
+	vector<char> default_row(3*size_t(width));
+	for(int c = 0; c < width; c++){
+		memcpy(&default_row[3*size_t(c)],default_rgb,3);
+	}
+
+	//fichier image à sa taille finale
+	string header = image_header(width,height);
+	size_t size = header.size()+3*size_t(width)*height;
+	int fd = open(image_name.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+	if (fd < 0 || ftruncate(fd,size) != 0 || pwrite(fd,header.data(),header.size(),0) != ssize_t(header.size())){
+		if (fd >= 0){
+			close(fd);
+		}
+		cout << "Impossible de créer " << image_name << endl;
+		return 0;
+	}
+
+	triangle_grid grid;
+	build_triangle_grid(points,t,context,grid);
+
+	//une rangée de tuiles à la fois : les suites de tuiles occupées voisines sont rendues puis écrites ligne par ligne,
+	//toute la largeur l'est si la couleur par défaut n'est pas noire (remplissage des tuiles vides)
+	double compute_seconds = 0, write_seconds = 0;
+	bool result = true;
+	vector<char> run, tile_image;
+	for(int ty = 0; ty < nb_tiles_y && result; ty++){
+		int r0 = ty*tile_size;
+		int r1 = min(height,r0+tile_size);
+		int tx = 0;
+		while(tx < nb_tiles_x && result){
+			int run_begin = tx, run_end = tx;
+			if (black){
+				while(run_begin < nb_tiles_x && !occupied[size_t(ty)*nb_tiles_x+run_begin]){
+					run_begin++;
+				}
+				run_end = run_begin;
+				while(run_end < nb_tiles_x && occupied[size_t(ty)*nb_tiles_x+run_end]){
+					run_end++;
+				}
+			}
+			else{
+				run_end = nb_tiles_x;
+			}
+			tx = run_end;
+			if (run_begin == run_end){
+				continue;
+			}
+			int c0 = run_begin*tile_size;
+			int c1 = min(width,run_end*tile_size);
+			size_t row_size = 3*size_t(c1-c0);
+			run.resize(row_size*(r1-r0));
+			for(int r = r0; r < r1; r++){
+				memcpy(&run[row_size*(r-r0)],&default_row[3*size_t(c0)],row_size);
+			}
+
+			auto t0 = chrono::steady_clock::now();
+			for(int k = run_begin; k < run_end; k++){
+				if (!occupied[size_t(ty)*nb_tiles_x+k]){
+					continue;
+				}
+				int tc0 = k*tile_size;
+				int tc1 = min(width,tc0+tile_size);
+				render_tile(points,t,grid,context,tc0,tc1,r0,r1,tile_image);
+				size_t tile_row_size = 3*size_t(tc1-tc0);
+				for(int r = r0; r < r1; r++){
+					memcpy(&run[row_size*(r-r0)+3*size_t(tc0-c0)],&tile_image[tile_row_size*(r-r0)],tile_row_size);
+				}
+			}
+			auto t1 = chrono::steady_clock::now();
+			compute_seconds += chrono::duration<double>(t1-t0).count();
+
+			//les lignes de la suite, d'un seul bloc si elle couvre toute la largeur
+			if (c0 == 0 && c1 == width){
+				result = pwrite(fd,run.data(),run.size(),header.size()+3*size_t(r0)*width) == ssize_t(run.size());
+			}
+			else{
+				for(int r = r0; r < r1 && result; r++){
+					off_t position = header.size()+3*(size_t(r)*width+c0);
+					result = pwrite(fd,&run[row_size*(r-r0)],row_size,position) == ssize_t(row_size);
+				}
+			}
+			write_seconds += chrono::duration<double>(chrono::steady_clock::now()-t1).count();
+		}
+	}
+	close(fd);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	cout << "- Sparse tiles rendered in " << compute_seconds << " s and written in " << write_seconds << " s, total " << seconds << " s" << endl;
+	if (!result){
+		cout << "Erreur d'écriture de " << image_name << endl;
+	}
+	return result;
+}
+
+static void mark_tiles(point_cloud &points, tin &t, map<string,double> &context, int tile_size, vector<char> &occupied){
+	/**
+	* \brief Marque les tuiles de l'image qui touchent le rectangle englobant d'au moins un triangle conservé.
+	* \param points Points de la triangulation.
+	* \param t Triangulation.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise la taille et les limites de l'image et le nombre de threads (nb_threads).
+	* \param tile_size taille des tuiles en pixels.
+	* \param occupied Vecteur dans lequel stocker les tuiles occupées (1) ou vides (0), ligne par ligne.
+	*/
+	int nb_tiles_x = (int(context["width"])+tile_size-1)/tile_size;
+	int nb_tiles_y = (int(context["height"])+tile_size-1)/tile_size;
+	double min_x = context["min_x"];
+	double max_y = context["max_y"];
+	double lg_pix = context["lg_pix"];
+	double h_pix = context["h_pix"];
+	auto tile_x = [&](double x){ return min(nb_tiles_x-1,max(0,int(floor((x-min_x)/lg_pix))/tile_size)); };
+	auto tile_y = [&](double y){ return min(nb_tiles_y-1,max(0,int(floor((max_y-y)/h_pix))/tile_size)); };
+
+	int nb_threads = max(1,int(context["nb_threads"]));
+	vector<vector<char>> thread_occupied(nb_threads,vector<char>(size_t(nb_tiles_x)*nb_tiles_y,0));
+	parallel_for(t.kept.size(),nb_threads,[&](size_t begin, size_t end, int thread){
+		vector<char> &tiles = thread_occupied[thread];
+		for(size_t i = begin; i < end; i++){
+			if (!t.kept[i]){
+				continue;
+			}
+			const tin_index *v = &t.triangles[3*i];
+			double x0 = min({points.x(v[0]),points.x(v[1]),points.x(v[2])});
+			double x1 = max({points.x(v[0]),points.x(v[1]),points.x(v[2])});
+			double y0 = min({points.y(v[0]),points.y(v[1]),points.y(v[2])});
+			double y1 = max({points.y(v[0]),points.y(v[1]),points.y(v[2])});
+			for(int ty = tile_y(y1); ty <= tile_y(y0); ty++){
+				for(int tx = tile_x(x0); tx <= tile_x(x1); tx++){
+					tiles[size_t(ty)*nb_tiles_x+tx] = 1;
+				}
+			}
+		}
+	});
+	occupied.assign(size_t(nb_tiles_x)*nb_tiles_y,0);
+	for(vector<char> &tiles : thread_occupied){
+		for(size_t k = 0; k < occupied.size(); k++){
+			occupied[k] |= tiles[k];
+		}
+	}
+}
+
+static void render_tile(point_cloud &points, tin &t, triangle_grid &grid, map<string,double> &context, int c0, int c1, int r0, int r1, vector<char> &image){
+	/**
+	* \brief Rend une tuile de l'image avec les pixels de l'image entière et la convertit en couleurs.
+	* \param points Points de la triangulation.
+	* \param t Triangulation.
+	* \param grid Index spatial des triangles conservés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param c0,c1,r0,r1 colonnes et lignes de la tuile dans l'image (fin exclue).
+	* \param image Vecteur dans lequel stocker les couleurs des pixels de la tuile, ligne par ligne.
+	*/
+	int width = context["width"];
+	int height = context["height"];
+
+	//fenêtre de la tuile, alignée sur les pixels de l'image
+	map<string,double> tile_context = context;
+	tile_context["min_x"] = (c0 == 0) ? context["min_x"] : context["min_x"]+c0*context["lg_pix"];
+	tile_context["max_x"] = (c1 == width) ? context["max_x"] : context["min_x"]+c1*context["lg_pix"];
+	tile_context["max_y"] = (r0 == 0) ? context["max_y"] : context["max_y"]-r0*context["h_pix"];
+	tile_context["min_y"] = (r1 == height) ? context["min_y"] : context["max_y"]-r1*context["h_pix"];
+	tile_context["width"] = c1-c0;
+	tile_context["height"] = r1-r0;
+	vector<size_t> selection;
+	select_triangles(grid,t,tile_context["min_x"],tile_context["max_x"],tile_context["min_y"],tile_context["max_y"],selection);
+	vector<int> pixels(size_t(c1-c0)*(r1-r0),context["default_color"]);
+	vector<double> pixels_illumination(pixels.size(),1);
+	color_triangles(points,t,pixels,pixels_illumination,tile_context,&selection); //(Voir triangulation.cpp)
+	image.resize(3*pixels.size());
+	colorize_band(pixels,pixels_illumination,tile_context,image.data()); //(Voir generate_image.cpp)
+}
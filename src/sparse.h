@@ -0,0 +1,23 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include "struct_point.h"
+#include "triangulation.h"
+#include "dem.h"
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+/**
+* \file sparse.h
+* \brief Fichier de déclaration du rendu par tuiles creuses : seules les tuiles de l'image touchées par un triangle conservé
+* sont allouées et rendues, les autres restent implicitement à la couleur par défaut.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+bool use_sparse(std::map<std::string,double> &context, pixel_channels *channels = nullptr);
+int render_sparse(point_cloud &points, tin &t, std::map<std::string,double> &context, std::string image_name = "raster.ppm");
+
+#endif
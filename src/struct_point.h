@@ -1,13 +1,39 @@
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "memory.h"
+
 #ifndef STRUCT_POINT_H
 #define STRUCT_POINT_H
 
 /**
 * \file struct_point.h
-* \brief Fichier de déclaration de la structure d'un point.
+* \brief Fichier de déclaration de la structure d'un point et du nuage de points.
 * \date 04/01/2022
 * \author NOEL Océan
 */
 
+//types de la triangulation, choisis à la compilation (voir CMakeLists.txt) :
+//- indices des points et des demi-arêtes sur 32 bits (jusqu'à environ 715 millions de points), 64 bits avec CREATE_RASTER_64BIT_INDICES
+//- coordonnées lues par delaunator en double directement dans le nuage de points, ou copiées en float par rapport
+//  au coin (min_x,min_y) du relevé avec CREATE_RASTER_FLOAT_COORDS
+#ifdef CREATE_RASTER_64BIT_INDICES
+typedef std::size_t tin_index;
+#else
+typedef std::uint32_t tin_index;
+#endif
+#ifdef CREATE_RASTER_FLOAT_COORDS
+typedef float tin_coord;
+#else
+typedef double tin_coord;
+#endif
+const tin_index no_halfedge = std::numeric_limits<tin_index>::max(); //demi-arête sans opposée (bord de la triangulation)
+
+//tableaux des principales structures, dont la mémoire est comptée par catégorie (voir memory.h)
+typedef std::vector<double,counting_allocator<double,memory_points>> cloud_vector;
+typedef std::vector<tin_index,counting_allocator<tin_index,memory_triangulation>> index_vector;
+
 struct point
 {
 	/**
@@ -19,4 +45,27 @@ struct point
 	double x, y, depth;
 };
 
-#endif
\ No newline at end of file
+struct point_cloud
+{
+	/**
+	* \brief Nuage de points stocké par tableaux (une seule copie des coordonnées, partagée par toutes les étapes).
+	* \param coords coordonnées des points sous forme {x0,y0,x1,y1...}, utilisées directement par delaunator.
+	* \param depth profondeurs des points.
+	* Un point est reconstruit à la demande (operator[]), il n'est jamais stocké.
+	*/
+	cloud_vector coords;
+	cloud_vector depth;
+
+	std::size_t size() const { return depth.size(); }
+	bool empty() const { return depth.empty(); }
+	double x(std::size_t i) const { return coords[2*i]; }
+	double y(std::size_t i) const { return coords[2*i+1]; }
+	point operator[](std::size_t i) const { return {coords[2*i],coords[2*i+1],depth[i]}; }
+	void set(std::size_t i, const point &p){ coords[2*i] = p.x; coords[2*i+1] = p.y; depth[i] = p.depth; }
+	void push_back(const point &p){ coords.push_back(p.x); coords.push_back(p.y); depth.push_back(p.depth); }
+	void resize(std::size_t n){ coords.resize(2*n); depth.resize(n); }
+	void reserve(std::size_t n){ coords.reserve(2*n); depth.reserve(n); }
+	void clear(){ cloud_vector().swap(coords); cloud_vector().swap(depth); }
+};
+
+#endif
@@ -0,0 +1,384 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h> //décompression gzip
+#include "parallel.h"
+#include "text_reader.h"
+
+/**
+* \file text_reader.cpp
+* \brief Fichier d'implémentation de la lecture ligne par ligne des fichiers de relevés, texte ou compressés en gzip.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static bool is_gzip_header(const unsigned char *p, const unsigned char *end);
+static size_t gzip_trailer_size(const unsigned char *member_end);
+
+static const size_t chunk_size = 1<<20; //taille des blocs de texte passés au lecteur de lignes
+static const size_t segment_size = 1<<20; //taille compressée minimale d'un segment décompressé par un thread
+
+text_reader::text_reader(const string &file_name, int nb_threads) : nb_threads(max(1,nb_threads)), chunks(4)
+{
+	/**
+	* \brief Ouvre le fichier et lance le thread de lecture. Les deux premiers octets indiquent si le fichier est compressé en gzip.
+	* Un fichier compressé est projeté en mémoire ; avec plusieurs threads, les débuts possibles des membres gzip sont
+	* recherchés (octets 1f 8b 08) pour décompresser le fichier par segments en parallèle.
+	* \param file_name chemin du fichier.
+	* \param nb_threads nombre de threads de décompression d'un fichier gzip de plusieurs membres.
+	*/
+	fd = open(file_name.c_str(),O_RDONLY);
+	if (fd < 0){
+		chunks.close(); //aucun thread de lecture : la file est vide et fermée
+		return;
+	}
+	struct stat file_stat;
+	unsigned char magic[2] = {0,0};
+	if (fstat(fd,&file_stat) == 0){
+		file_size = file_stat.st_size;
+	}
+	if (file_size >= 18 && pread(fd,magic,2,0) == 2 && magic[0] == 0x1f && magic[1] == 0x8b){
+		void *map = mmap(nullptr,file_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if (map != MAP_FAILED){
+			data = (const unsigned char*)map;
+			madvise(map,file_size,MADV_SEQUENTIAL);
+			compressed = true;
+		}
+	}
+
+	if (!compressed){
+		producer = thread(&text_reader::read_plain,this);
+		return;
+	}
+	if (this->nb_threads > 1){
+		const unsigned char *end = data+file_size;
+		const unsigned char *p = data+1;
+		while(p < end && (p = (const unsigned char*)memchr(p,0x1f,end-p)) != nullptr){
+			if (is_gzip_header(p,end)){
+				members.push_back(p-data);
+			}
+			p++;
+		}
+	}
+	if (members.empty()){
+		producer = thread(&text_reader::inflate_sequential,this,size_t(0));
+	}
+	else{
+		producer = thread(&text_reader::inflate_parallel,this);
+	}
+}
+
+text_reader::~text_reader()
+{
+	/**
+	* \brief Arrête le thread de lecture (même si toutes les lignes n'ont pas été lues) et ferme le fichier.
+	*/
+	stop = true;
+	if (producer.joinable()){
+		vector<char> ignored;
+		while(chunks.pop(ignored)){ //libère le thread de lecture s'il attend de la place dans la file
+		}
+		producer.join();
+	}
+	if (data != nullptr){
+		munmap((void*)data,file_size);
+	}
+	if (fd >= 0){
+		close(fd);
+	}
+}
+
+bool text_reader::is_open() const
+{
+	/**
+	* \return true si le fichier a pu être ouvert.
+	*/
+	return fd >= 0;
+}
+
+bool text_reader::is_compressed() const
+{
+	/**
+	* \return true si le fichier est compressé en gzip.
+	*/
+	return compressed;
+}
+
+bool text_reader::failed() const
+{
+	/**
+	* \return true si la lecture ou la décompression a échoué (fichier gzip tronqué ou corrompu).
+	*/
+	return error;
+}
+
+size_t text_reader::size_hint() const
+{
+	/**
+	* \brief Taille estimée du texte du fichier, pour réserver la mémoire du nuage de points.
+	* Pour un fichier gzip, c'est la somme des tailles décompressées (modulo 2^32) écrites à la fin de chaque membre.
+	* \return Taille en octets, 0 si elle est inconnue.
+	*/
+	if (!compressed){
+		return file_size;
+	}
+	size_t size = gzip_trailer_size(data+file_size);
+	for(size_t member : members){
+		size += gzip_trailer_size(data+member);
+	}
+	return size;
+}
+
+bool text_reader::getline(string &line)
+{
+	/**
+	* \brief Lit la ligne suivante (sans le retour à la ligne), comme std::getline.
+	* \param line ligne lue.
+	* \return false à la fin du fichier.
+	*/
+	line.clear();
+	bool found = false;
+	while(true){
+		if (chunk_pos >= chunk.size()){
+			if (!chunks.pop(chunk)){
+				return found;
+			}
+			chunk_pos = 0;
+			continue;
+		}
+		found = true;
+		const char *begin = chunk.data()+chunk_pos;
+		size_t n = chunk.size()-chunk_pos;
+		const char *end_of_line = (const char*)memchr(begin,'\n',n);
+		if (end_of_line != nullptr){
+			line.append(begin,end_of_line-begin);
+			chunk_pos += end_of_line-begin+1;
+			return true;
+		}
+		line.append(begin,n);
+		chunk_pos = chunk.size();
+	}
+}
+
+bool text_reader::push_chunk(vector<char> &block)
+{
+	/**
+	* \brief Passe un bloc de texte au lecteur de lignes (attend qu'il y ait de la place dans la file).
+	* \return false si le lecteur a été détruit avant la fin du fichier.
+	*/
+	if (stop){
+		return false;
+	}
+	if (!block.empty()){
+		chunks.push(move(block));
+	}
+	return true;
+}
+
+void text_reader::read_plain()
+{
+	/**
+	* \brief Thread de lecture d'un fichier texte par blocs.
+	*/
+	while(true){
+		vector<char> block(chunk_size);
+		ssize_t n = read(fd,block.data(),chunk_size);
+		if (n < 0){
+			error = true;
+			break;
+		}
+		if (n == 0){
+			break;
+		}
+		block.resize(n);
+		if (!push_chunk(block)){
+			break;
+		}
+	}
+	chunks.close();
+}
+
+bool text_reader::inflate_range(size_t begin, size_t end, const function<bool(vector<char>&)> &output, size_t &stopped_at)
+{
+	/**
+	* \brief Décompresse les membres gzip consécutifs de [begin,end[ par blocs de texte.
+	* La somme de contrôle (CRC32) et la taille de chaque membre sont vérifiées par zlib.
+	* \param begin début du premier membre dans le fichier.
+	* \param end fin de la zone à décompresser.
+	* \param output fonction appelée sur chaque bloc de texte, qui renvoie false pour arrêter la décompression.
+	* \param stopped_at fin du dernier membre complet. Des données qui ne sont pas un membre gzip arrêtent la décompression.
+	* \return false si un membre est tronqué ou corrompu.
+	*/
+	stopped_at = begin;
+	z_stream zs;
+	memset(&zs,0,sizeof(zs));
+	if (inflateInit2(&zs,16+MAX_WBITS) != Z_OK){ //16 : format gzip
+		return false;
+	}
+	bool ok = true;
+	size_t pos = begin;
+	vector<char> block(chunk_size);
+	zs.next_out = (Bytef*)block.data();
+	zs.avail_out = chunk_size;
+	while(true){
+		if (zs.avail_in == 0 && pos < end){ //avail_in est sur 32 bits
+			size_t n = min<size_t>(end-pos,1<<30);
+			zs.next_in = (Bytef*)(data+pos);
+			zs.avail_in = n;
+			pos += n;
+		}
+		int result = inflate(&zs,Z_NO_FLUSH);
+		bool done = false;
+		if (result == Z_STREAM_END){
+			stopped_at = pos-zs.avail_in;
+			if (stopped_at >= end || !is_gzip_header(data+stopped_at,data+end)){
+				done = true;
+			}
+			else{
+				inflateReset(&zs); //membre suivant
+			}
+		}
+		else if (result != Z_OK){ //Z_BUF_ERROR : plus de données avant la fin du membre
+			ok = false;
+			done = true;
+		}
+		if (zs.avail_out == 0 || done){
+			block.resize(chunk_size-zs.avail_out);
+			if (!block.empty() && !output(block)){
+				break;
+			}
+			block.assign(chunk_size,0);
+			zs.next_out = (Bytef*)block.data();
+			zs.avail_out = chunk_size;
+		}
+		if (done){
+			break;
+		}
+	}
+	inflateEnd(&zs);
+	return ok;
+}
+
+void text_reader::inflate_sequential(size_t offset)
+{
+	/**
+	* \brief Thread de décompression d'un fichier gzip à partir d'un début de membre.
+	* Comme gzip, les données qui suivent le dernier membre sont ignorées.
+	* \param offset début du premier membre à décompresser.
+	*/
+	size_t stopped_at = 0;
+	if (!inflate_range(offset,file_size,[this](vector<char> &block){ return push_chunk(block); },stopped_at) && !stop){
+		error = true;
+	}
+	chunks.close();
+}
+
+void text_reader::inflate_parallel()
+{
+	/**
+	* \brief Thread de décompression d'un fichier gzip de plusieurs membres.
+	* Le fichier est découpé en segments d'au moins segment_size octets aux débuts possibles de membres, puis chaque groupe
+	* de nb_threads segments est décompressé en parallèle et passé dans l'ordre au lecteur de lignes.
+	* Les octets 1f 8b 08 peuvent aussi apparaitre dans les données compressées : un segment n'est valide que si
+	* sa décompression se termine exactement à la fin du segment. Le premier segment commence au début du fichier,
+	* donc le début d'un segment qui suit un segment valide est un vrai début de membre ; à partir d'un segment invalide,
+	* la décompression continue sans parallélisme.
+	*/
+	vector<size_t> bounds = {0};
+	for(size_t member : members){
+		if (member-bounds.back() >= segment_size){
+			bounds.push_back(member);
+		}
+	}
+	bounds.push_back(file_size);
+	size_t nb_segments = bounds.size()-1;
+
+	for(size_t first = 0; first < nb_segments && !stop; first += nb_threads){
+		size_t nb = min<size_t>(nb_threads,nb_segments-first);
+		vector<vector<vector<char>>> outputs(nb);
+		vector<char> valid(nb,0);
+		parallel_for(nb,nb_threads,[&](size_t b, size_t e, int){
+			for(size_t i = b; i < e; i++){
+				size_t stopped_at = 0;
+				bool ok = inflate_range(bounds[first+i],bounds[first+i+1],[&](vector<char> &block){
+					outputs[i].push_back(move(block));
+					return !stop;
+				},stopped_at);
+				valid[i] = ok && stopped_at == bounds[first+i+1];
+			}
+		});
+		for(size_t i = 0; i < nb; i++){
+			if (!valid[i]){
+				if (!stop){
+					inflate_sequential(bounds[first+i]); //ferme la file
+				}
+				else{
+					chunks.close();
+				}
+				return;
+			}
+			for(vector<char> &block : outputs[i]){
+				if (!push_chunk(block)){
+					chunks.close();
+					return;
+				}
+			}
+			vector<vector<char>>().swap(outputs[i]);
+		}
+	}
+	chunks.close();
+}
+
+size_t text_file_size(const string &file_name)
+{
+	/**
+	* \brief Taille estimée du texte d'un fichier de relevés, sans le lire : taille du fichier, ou pour un fichier gzip
+	* la taille décompressée écrite à la fin du dernier membre (au moins la taille compressée).
+	* \param file_name chemin du fichier.
+	* \return Taille en octets, 0 si le fichier n'existe pas.
+	*/
+	int fd = open(file_name.c_str(),O_RDONLY);
+	if (fd < 0){
+		return 0;
+	}
+	struct stat file_stat;
+	size_t size = (fstat(fd,&file_stat) == 0) ? file_stat.st_size : 0;
+	unsigned char magic[2] = {0,0};
+	unsigned char trailer[4];
+	if (size >= 18 && pread(fd,magic,2,0) == 2 && magic[0] == 0x1f && magic[1] == 0x8b
+		&& pread(fd,trailer,4,size-4) == 4){
+		size = max(size,gzip_trailer_size(trailer+4));
+	}
+	close(fd);
+	return size;
+}
+
+static bool is_gzip_header(const unsigned char *p, const unsigned char *end)
+{
+	/**
+	* \brief Teste si un entête de membre gzip peut commencer en p : octets 1f 8b, méthode 8 (deflate), bits réservés nuls.
+	* \param p début possible du membre.
+	* \param end fin des données.
+	* \return true si c'est un début possible de membre.
+	*/
+	return end-p >= 18 && p[0] == 0x1f && p[1] == 0x8b && p[2] == 8 && (p[3] & 0xe0) == 0;
+}
+
+static size_t gzip_trailer_size(const unsigned char *member_end)
+{
+	/**
+	* \brief Lit la taille décompressée (modulo 2^32, petit-boutiste) des 4 derniers octets d'un membre gzip.
+	* \param member_end fin du membre.
+	* \return Taille en octets.
+	*/
+	const unsigned char *p = member_end-4;
+	return size_t(p[0]) | (size_t(p[1])<<8) | (size_t(p[2])<<16) | (size_t(p[3])<<24);
+}
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include "parallel.h"
+
+#ifndef TEXT_READER_H
+#define TEXT_READER_H
+
+/**
+* \file text_reader.h
+* \brief Fichier de déclaration de la lecture ligne par ligne des fichiers de relevés, texte ou compressés en gzip.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+class text_reader
+{
+/**
+* \class text_reader
+* \brief Lecteur de lignes d'un fichier texte, décompressé à la volée s'il est au format gzip (.gz).
+* Un thread lit (ou décompresse) le fichier par blocs qui passent par une file de taille limitée vers le thread qui lit les lignes.
+* Un fichier gzip de plusieurs membres (pigz --independent, fichiers concaténés) est décompressé par plusieurs threads.
+*/
+public:
+	text_reader(const std::string &file_name, int nb_threads = 1);
+	~text_reader();
+	bool is_open() const;
+	bool is_compressed() const;
+	bool failed() const;
+	bool getline(std::string &line);
+	std::size_t size_hint() const;
+
+private:
+	void read_plain();
+	void inflate_sequential(std::size_t offset);
+	void inflate_parallel();
+	bool inflate_range(std::size_t begin, std::size_t end, const std::function<bool(std::vector<char>&)> &output, std::size_t &stopped_at);
+	bool push_chunk(std::vector<char> &chunk);
+
+	int fd = -1;
+	const unsigned char *data = nullptr; //fichier compressé projeté en mémoire
+	std::size_t file_size = 0;
+	bool compressed = false;
+	int nb_threads = 1;
+	std::vector<std::size_t> members; //débuts possibles des membres gzip (mode parallèle)
+
+	bounded_queue<std::vector<char>> chunks;
+	std::thread producer;
+	std::atomic<bool> stop{false};
+	std::atomic<bool> error{false};
+	std::vector<char> chunk; //bloc en cours de lecture
+	std::size_t chunk_pos = 0;
+};
+
+std::size_t text_file_size(const std::string &file_name);
+
+#endif
@@ -0,0 +1,198 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <ctime> //temps, mesures d'executions
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <math.h>
+#include "struct_point.h"
+#include "parallel.h"
+#include "thinning.h"
+
+/**
+* \file thinning.cpp
+* \brief Fichier d'implémentation de la réduction du nombre de points avant triangulation (une valeur par case d'une grille).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+struct cell_value
+{
+	/**
+	* \brief Accumulation des points d'une case.
+	* \param first indice du premier point de la case (ordre des points conservés).
+	* \param chosen indice du point retenu (profondeur min ou max).
+	* \param sum_x,sum_y,sum_depth,nb sommes pour la moyenne.
+	* \param members indices des points de la case (médiane uniquement).
+	*/
+	size_t first = 0, chosen = 0;
+	double sum_x = 0, sum_y = 0, sum_depth = 0;
+	size_t nb = 0;
+	vector<size_t> members;
+};
+
+int read_thinning(string str, map<string,double> &context){
+	/**
+	* \brief Lis le mode de réduction des points : none, min (le moins profond), max (le plus profond), mean ou median.
+	* \param str texte à analyser.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales), initialise thinning.
+	* \return 1 si le mode est valide, 0 sinon.
+	*/
+	vector<string> modes = {"none","min","max","mean","median"};
+	for(size_t i = 0; i < modes.size(); i++){
+		if (str == modes[i]){
+			context["thinning"] = i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void thin_points(point_cloud &points, map<string,double> &context){
+	/**
+	* \brief Remplace les points de chaque case d'une grille par un seul point, ce qui réduit le nombre de points à trianguler
+	* et supprime les doublons exacts. La taille des cases est thinning_tolerance fois la taille d'un pixel,
+	* une tolérance nulle ne fusionne que les points de mêmes coordonnées.
+	* Les cases sont réparties entre les threads selon leur hash, chaque thread a sa propre table.
+	* Le point d'une case est, selon le mode : le moins profond (min), le plus profond (max), la moyenne des points (mean)
+	* ou le point de profondeur médiane (median). Les limites du nuage de points ne sont pas modifiées.
+	* \param points Points projetés, remplacés par les points retenus.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin de :
+	* - le mode et la tolérance (thinning,thinning_tolerance)
+	* - les limites du nuage de points et la taille de l'image (min_x,max_x,min_y,max_y,width,height)
+	* - le nombre de threads (nb_threads)
+	* Elle initialise thinning_cell, la taille des cases en m.
+	*/
+
+	//variables analytiques
+	time_t t0,tf;
+	cout << "- Thinning points...";
+	time(&t0);
+
+	int mode = context["thinning"];
+	double min_x = context["min_x"];
+	double min_y = context["min_y"];
+	double lg_pix = (context["max_x"]-min_x)/context["width"];
+	double h_pix = (context["max_y"]-min_y)/context["height"];
+	double cell = context["thinning_tolerance"]*min(lg_pix,h_pix);
+	context["thinning_cell"] = cell; //taille des cases, utilisée pour la longueur maximale des triangles
+	int nb_threads = max(1,int(context["nb_threads"]));
+	size_t nb_points = points.size();
+
+	//case de chaque point
+	vector<cell_key> keys(nb_points);
+	parallel_for(nb_points,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			if (cell > 0){
+				keys[i] = {int64_t(floor((points.x(i)-min_x)/cell)),int64_t(floor((points.y(i)-min_y)/cell))};
+			}
+			else{ //doublons exacts uniquement
+				memcpy(&keys[i].a,&points.coords[2*i],sizeof(double));
+				memcpy(&keys[i].b,&points.coords[2*i+1],sizeof(double));
+			}
+		}
+	});
+
+	//accumulation : le thread t traite les cases dont le hash vaut t modulo nb_threads
+	vector<vector<size_t>> buckets;
+	partition_cells(keys,nb_threads,buckets);
+	vector<vector<pair<size_t,point>>> results(nb_threads);
+	parallel_for(nb_threads,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t t = begin; t < end; t++){
+			unordered_map<cell_key,cell_value,cell_key_hash> cells;
+			for(size_t i : buckets[t]){
+				auto found = cells.find(keys[i]);
+				if (found == cells.end()){
+					found = cells.emplace(keys[i],cell_value()).first;
+					found->second.first = i;
+					found->second.chosen = i;
+				}
+				cell_value &c = found->second;
+				point p = points[i];
+				c.sum_x += p.x;
+				c.sum_y += p.y;
+				c.sum_depth += p.depth;
+				c.nb++;
+				if ((mode == 1 && p.depth > points.depth[c.chosen]) || (mode == 2 && p.depth < points.depth[c.chosen])){ //profondeurs négatives
+					c.chosen = i;
+				}
+				if (mode == 4){
+					c.members.push_back(i);
+				}
+			}
+
+			//point retenu de chaque case
+			for(auto &entry : cells){
+				cell_value &c = entry.second;
+				point p = points[c.chosen];
+				if (mode == 3){
+					p = {c.sum_x/c.nb,c.sum_y/c.nb,c.sum_depth/c.nb};
+				}
+				else if (mode == 4){
+					auto middle = c.members.begin()+c.members.size()/2;
+					nth_element(c.members.begin(),middle,c.members.end(),[&](size_t i, size_t j){ return points.depth[i] < points.depth[j]; });
+					p = points[*middle];
+				}
+				results[t].push_back({c.first,p});
+			}
+		}
+	});
+
+	vector<vector<size_t>>().swap(buckets);
+
+	//rassemblement dans l'ordre des points d'origine
+	vector<pair<size_t,point>> kept;
+	for(auto &r : results){
+		kept.insert(kept.end(),r.begin(),r.end());
+		vector<pair<size_t,point>>().swap(r);
+	}
+	sort(kept.begin(),kept.end(),[](const pair<size_t,point> &a, const pair<size_t,point> &b){ return a.first < b.first; });
+	points.resize(kept.size());
+	for(size_t i = 0; i < kept.size(); i++){
+		points.set(i,kept[i].second);
+	}
+	points.coords.shrink_to_fit();
+	points.depth.shrink_to_fit();
+
+	time(&tf);
+	cout << " " << nb_points << " -> " << points.size() << " points (" << tf-t0 << " s)" << endl; //affichage du temps d'execution
+}
+
+void partition_cells(const vector<cell_key> &keys, int nb_threads, vector<vector<size_t>> &buckets){
+	/**
+	* \brief Répartit les points entre les threads selon le hash de leur case, en un seul parcours des points :
+	* chaque thread range les points de sa part dans ses propres listes, puis le thread t rassemble les listes t de tous les threads.
+	* Tous les points d'une case sont ainsi traités par le même thread, sans que chaque thread parcoure tous les points.
+	* \param keys case de chaque point.
+	* \param nb_threads nombre de threads (et de listes).
+	* \param buckets listes dans lesquelles stocker les indices des points de chaque thread, dans l'ordre croissant.
+	*/
+	cell_key_hash hash;
+	vector<vector<vector<size_t>>> parts(nb_threads,vector<vector<size_t>>(nb_threads));
+	parallel_for(keys.size(),nb_threads,[&](size_t begin, size_t end, int thread){
+		for(size_t i = begin; i < end; i++){
+			parts[thread][hash(keys[i])%nb_threads].push_back(i);
+		}
+	});
+	buckets.assign(nb_threads,vector<size_t>());
+	parallel_for(nb_threads,nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t t = begin; t < end; t++){
+			size_t size = 0;
+			for(int s = 0; s < nb_threads; s++){
+				size += parts[s][t].size();
+			}
+			buckets[t].reserve(size);
+			for(int s = 0; s < nb_threads; s++){ //les parts des threads suivent l'ordre des points
+				buckets[t].insert(buckets[t].end(),parts[s][t].begin(),parts[s][t].end());
+				vector<size_t>().swap(parts[s][t]);
+			}
+		}
+	});
+}
@@ -0,0 +1,38 @@
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <string>
+#include <cstdint>
+#include "struct_point.h"
+
+#ifndef THINNING_H
+#define THINNING_H
+
+/**
+* \file thinning.h
+* \brief Fichier de déclaration de la réduction du nombre de points avant triangulation (une valeur par case d'une grille).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+struct cell_key
+{
+	/**
+	* \brief Case de la grille d'un point : indices de la case, ou coordonnées exactes si la tolérance est nulle.
+	*/
+	int64_t a, b;
+	bool operator==(const cell_key &other) const { return a == other.a && b == other.b; }
+};
+
+struct cell_key_hash
+{
+	size_t operator()(const cell_key &k) const {
+		uint64_t h = uint64_t(k.a)*0x9E3779B97F4A7C15ULL ^ (uint64_t(k.b)+0x7F4A7C159E3779B9ULL+(uint64_t(k.a)<<6));
+		return size_t(h^(h>>29));
+	}
+};
+
+int read_thinning(std::string str, std::map<std::string,double> &context);
+void thin_points(point_cloud &points, std::map<std::string,double> &context);
+void partition_cells(const std::vector<cell_key> &keys, int nb_threads, std::vector<std::vector<std::size_t>> &buckets);
+
+#endif
@@ -0,0 +1,591 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <cstdint>
+#include <cstring>
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <fstream> //manipulation fichiers
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <ctime> //temps, mesures d'executions
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "struct_point.h"
+#include "triangulation.h"
+#include "init_points_pixels.h"
+#include "generate_image.h"
+#include "thinning.h"
+#include "tin_cache.h"
+#include "tiles.h"
+
+/**
+* \file tiles.cpp
+* \brief Fichier d'implémentation du rendu distribué par tuiles.
+* Le coordinateur lit et projette les points, puis écrit dans le dossier des tuiles un fichier par tuile avec ses points
+* et ceux d'une marge autour d'elle (tile_halo pixels) : les triangles de Delaunay qui touchent la tuile sont alors ceux de la
+* triangulation globale. Les travailleurs sont d'autres processus (le même programme avec --worker) qui ne communiquent
+* que par des fichiers dans ce dossier, il peut donc être partagé entre plusieurs machines (voir tile_launcher) :
+* - étape 1 : chaque travailleur triangule sa tuile et écrit les statistiques des plus grands cotés des triangles dont il est
+*   propriétaire, dont le coordinateur déduit la longueur maximale d'un coté de triangle du relevé entier (voir triangle_length_limit).
+*   Seuls les triangles de cercle circonscrit assez petit sont comptés et conservés, comme pour un rendu en une fois
+*   (voir statistics_radius) : la marge est élargie à deux fois ce rayon si besoin, ces triangles sont alors exactement
+*   ceux de la triangulation globale et l'image est la même qu'en une fois ;
+* - étape 2 : chaque travailleur relit sa triangulation du cache (voir tin_cache.cpp), sélectionne les triangles
+*   avec cette longueur et rend sa tuile, que le coordinateur recopie à sa place dans l'image.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+extern char **environ;
+
+struct tile_header
+{
+	/**
+	* \brief Entête d'un fichier de tuile, suivi des points de la tuile et de sa marge (struct point).
+	* \param magic "CRTILE" pour reconnaitre le fichier.
+	* \param version version du format.
+	* \param column,row position en pixels du coin supérieur gauche de la tuile dans l'image.
+	* \param width,height taille de la tuile en pixels.
+	* \param image_width,image_height taille de l'image entière en pixels.
+	* \param min_x,max_x,min_y,max_y emprise de la tuile en m, sans la marge.
+	* \param image_min_x,image_max_x,image_min_y,image_max_y emprise de l'image entière (grille de la réduction des points).
+	* \param lg_pix,h_pix taille des pixels de l'image entière en m.
+	* \param min_depth,max_depth profondeurs extrêmes du relevé entier (colormap).
+	* \param stats_radius rayon maximal des triangles comptés et conservés en m (voir statistics_radius), 0 sans limite.
+	*/
+	char magic[8];
+	uint32_t version;
+	int32_t column, row;
+	int32_t width, height;
+	int32_t image_width, image_height;
+	uint32_t reserved;
+	double min_x, max_x, min_y, max_y;
+	double image_min_x, image_max_x, image_min_y, image_max_y;
+	double lg_pix, h_pix;
+	double min_depth, max_depth;
+	double stats_radius;
+};
+
+static void write_tiles(const string &spool_name, vector<tile_header> &headers, const vector<string> &names, int nb_columns, double halo);
+static int run_workers(const vector<vector<string>> &commands, const vector<string> &logs, int nb_parallel, const string &launcher);
+static pid_t spawn_worker(const vector<string> &command, const string &log, size_t index, const string &launcher);
+static int stitch_tiles(const vector<tile_header> &headers, const vector<string> &images, int width, int height, const string &image_name);
+static string executable_path();
+static string shell_quote(const string &arg);
+
+static const uint32_t tile_file_version = 2;
+static const size_t tile_block_size = 65536; //points lus ou écrits à la fois
+
+int run_tiles(string file_name, map<string,double> &context, map<string,string> &paths, const vector<string> &options){
+	/**
+	* \brief Rend l'image d'un relevé par tuiles, chacune dans un processus travailleur, puis les assemble dans raster.ppm.
+	* \param file_name nom du fichier du relevé.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise le nombre de tuiles par coté (tiles), la marge en pixels (tile_halo),
+	* le nombre de travailleurs simultanés (tile_workers, nb_threads si 0) et la taille de l'image (width,height).
+	* \param paths Dictionnaire des chemins donnés en options, ici le dossier des tuiles (tile_dir)
+	* et la commande qui lance les travailleurs (tile_launcher, voir spawn_worker).
+	* \param options Options du programme, données aussi aux travailleurs.
+	* \return 1 si l'image a été écrite, 0 sinon.
+	*/
+	time_t t0,tf;
+	time(&t0);
+	string directory = (paths["tile_dir"] != "") ? paths["tile_dir"] : "tiles";
+	mkdir(directory.c_str(),0755); //le dossier peut déjà exister
+	int width = context["width"];
+	int height = context["height"];
+	int n = min({int(context["tiles"]),width,height}); //tuiles par coté
+	int nb_tiles = n*n;
+	cout << endl << "Tiled rendering (" << n << "x" << n << " tiles in " << directory << ") :" << endl;
+
+	//lecture et projection des points, mis de coté dans un fichier jusqu'à ce que l'emprise du relevé soit connue
+	string spool_name = directory+"/points.bin";
+	ofstream spool(spool_name,ios::binary);
+	int result = get_projected_points(file_name,nullptr,context,[&](vector<point> &block){ //(Voir init_point_pixels.cpp)
+		spool.write((const char*)block.data(),block.size()*sizeof(point));
+	});
+	spool.close();
+	if (result == 0 || spool.fail()){
+		cout << "echec de la récupération des points" << endl;
+		unlink(spool_name.c_str());
+		return 0;
+	}
+	set_pixel_size(context); //(Voir init_point_pixels.cpp)
+
+	//emprise des tuiles, alignée sur les pixels de l'image entière
+	double min_x = context["min_x"];
+	double max_x = context["max_x"];
+	double min_y = context["min_y"];
+	double max_y = context["max_y"];
+	double lg_pix = context["lg_pix"];
+	double h_pix = context["h_pix"];
+	double stats_radius = statistics_radius(context,0); //(Voir triangulation.cpp)
+
+	//marge : tile_halo pixels, élargie pour que les triangles comptés et conservés soient ceux de la triangulation globale
+	//(un cercle circonscrit de rayon stats_radius qui touche la tuile reste dans la marge, aux cases de la réduction près)
+	double halo = context["tile_halo"]*max(lg_pix,h_pix);
+	double cell = (context["thinning"] != 0) ? context["thinning_tolerance"]*min(lg_pix,h_pix) : 0;
+	if (halo < 2*stats_radius+2*cell){
+		halo = 2*stats_radius+2*cell;
+		cout << "- Tile halo widened to " << ceil(halo/max(lg_pix,h_pix)) << " pixels" << endl;
+	}
+	vector<tile_header> headers(nb_tiles);
+	vector<string> names(nb_tiles);
+	for(int i = 0; i < n; i++){
+		for(int j = 0; j < n; j++){
+			tile_header &h = headers[i*n+j];
+			memset(&h,0,sizeof(h));
+			memcpy(h.magic,"CRTILE",7);
+			h.version = tile_file_version;
+			int c0 = j*width/n;
+			int c1 = (j+1)*width/n;
+			int r0 = i*height/n;
+			int r1 = (i+1)*height/n;
+			h.column = c0;
+			h.row = r0;
+			h.width = c1-c0;
+			h.height = r1-r0;
+			h.image_width = width;
+			h.image_height = height;
+			h.min_x = (c0 == 0) ? min_x : min_x+c0*lg_pix;
+			h.max_x = (c1 == width) ? max_x : min_x+c1*lg_pix;
+			h.max_y = (r0 == 0) ? max_y : max_y-r0*h_pix;
+			h.min_y = (r1 == height) ? min_y : max_y-r1*h_pix;
+			h.image_min_x = min_x;
+			h.image_max_x = max_x;
+			h.image_min_y = min_y;
+			h.image_max_y = max_y;
+			h.lg_pix = lg_pix;
+			h.h_pix = h_pix;
+			h.min_depth = context["min_depth"];
+			h.max_depth = context["max_depth"];
+			h.stats_radius = stats_radius;
+			names[i*n+j] = directory+"/tile_"+to_string(i*n+j);
+		}
+	}
+
+	//répartition des points dans les tuiles et leurs marges
+	cout << "- Writing tiles...";
+	time_t t1,t2;
+	time(&t1);
+	write_tiles(spool_name,headers,names,n,halo);
+	unlink(spool_name.c_str());
+	time(&t2);
+	cout<<" ("<<t2-t1<<" s)"<<endl; //affichage du temps d'éxecution
+
+	//commandes des travailleurs, chacun avec une part des threads
+	int nb_parallel = (context["tile_workers"] > 0) ? int(context["tile_workers"]) : int(context["nb_threads"]);
+	nb_parallel = max(1,min(nb_parallel,nb_tiles));
+	int worker_threads = max(1,int(context["nb_threads"])/nb_parallel);
+	string executable = executable_path();
+	vector<vector<string>> commands(nb_tiles);
+	vector<string> logs(nb_tiles);
+	for(int k = 0; k < nb_tiles; k++){
+		commands[k] = {executable,"--worker",names[k]+".pts"};
+		commands[k].insert(commands[k].end(),options.begin(),options.end());
+		commands[k].insert(commands[k].end(),{"--threads",to_string(worker_threads)});
+		logs[k] = names[k]+".log";
+		unlink(logs[k].c_str()); //sorties des deux étapes à la suite
+	}
+
+	//étape 1 : triangulation des tuiles et statistiques des plus grands cotés de leurs triangles
+	cout << "- Triangulating tiles (" << nb_parallel << " workers)...";
+	time(&t1);
+	vector<vector<string>> stage_commands = commands;
+	for(vector<string> &command : stage_commands){
+		command.insert(command.end(),{"--tile_stage","1"});
+	}
+	if (run_workers(stage_commands,logs,nb_parallel,paths["tile_launcher"]) > 0){
+		return 0;
+	}
+	double sum = 0, sum_sq = 0, max_norm = 0, max_all = 0, thinning_cell = 0;
+	size_t nb_triangles = 0;
+	for(int k = 0; k < nb_tiles; k++){
+		ifstream stats(names[k]+".stats");
+		double tile_sum, tile_sum_sq, tile_max, tile_max_all, tile_cell;
+		size_t tile_count;
+		if (!(stats >> tile_sum >> tile_sum_sq >> tile_max >> tile_max_all >> tile_count >> tile_cell)){
+			cout << endl << "Statistiques de la tuile " << k << " illisibles" << endl;
+			return 0;
+		}
+		sum += tile_sum;
+		sum_sq += tile_sum_sq;
+		max_norm = max(max_norm,tile_max);
+		max_all = max(max_all,tile_max_all);
+		nb_triangles += tile_count;
+		thinning_cell = max(thinning_cell,tile_cell);
+		stats.close();
+		unlink((names[k]+".stats").c_str());
+	}
+	//aucun triangle compté : tous les triangles sont conservés, comme en une fois (voir triangulate),
+	//mais ceux du bord des tuiles peuvent alors différer de la triangulation globale
+	if (nb_triangles == 0){
+		max_norm = max_all;
+		for(int k = 0; k < nb_tiles; k++){
+			headers[k].stats_radius = 0;
+			fstream tile(names[k]+".pts",ios::binary|ios::in|ios::out);
+			tile.write((const char*)&headers[k],sizeof(tile_header));
+		}
+	}
+	double lim_triangle_lg = triangle_length_limit(sum,sum_sq,max_norm,nb_triangles,thinning_cell); //(Voir triangulation.cpp)
+	time(&t2);
+	cout<<" ("<<t2-t1<<" s)"<<endl; //affichage du temps d'éxecution
+
+	//étape 2 : rendu des tuiles avec la longueur maximale du relevé entier
+	cout << "- Rendering tiles...";
+	time(&t1);
+	ostringstream lim;
+	lim << setprecision(17) << lim_triangle_lg;
+	for(vector<string> &command : commands){
+		command.insert(command.end(),{"--tile_stage","2","--lim_triangle_lg",lim.str()});
+	}
+	if (run_workers(commands,logs,nb_parallel,paths["tile_launcher"]) > 0){
+		return 0;
+	}
+	time(&t2);
+	cout<<" ("<<t2-t1<<" s)"<<endl; //affichage du temps d'éxecution
+
+	//assemblage des images des tuiles
+	cout << "- Stitching tiles...";
+	time(&t1);
+	vector<string> images(nb_tiles);
+	for(int k = 0; k < nb_tiles; k++){
+		images[k] = names[k]+".ppm";
+	}
+	result = stitch_tiles(headers,images,width,height,"raster.ppm");
+	for(int k = 0; k < nb_tiles; k++){
+		unlink(images[k].c_str());
+		unlink((names[k]+".pts").c_str());
+	}
+	time(&t2);
+	cout<<" ("<<t2-t1<<" s)"<<endl; //affichage du temps d'éxecution
+	if (result == 0){
+		cout << "echec de l'assemblage des tuiles" << endl;
+	}
+
+	time(&tf);
+	cout << "- Tiled rendering done in " << tf-t0 << " s" << endl;
+	return result;
+}
+
+int run_tile_worker(string tile_file, map<string,double> &context){
+	/**
+	* \brief Travailleur du rendu par tuiles : triangule les points d'un fichier de tuile (étape 1, tile_stage = 1)
+	* ou rend la tuile (étape 2) dans le même dossier, avec le même nom que le fichier de tuile (.stats ou .ppm).
+	* \param tile_file fichier de tuile écrit par run_tiles.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise l'étape (tile_stage), la longueur maximale d'un coté de triangle du relevé entier
+	* (lim_triangle_lg, étape 2), la réduction des points (voir thin_points) et les paramètres du rendu (voir color_triangles).
+	* \return 0 si la tuile a été traitée, 1 sinon (code de sortie du processus).
+	*/
+	ifstream f(tile_file,ios::binary);
+	tile_header h;
+	if (!f.read((char*)&h,sizeof(h)) || memcmp(h.magic,"CRTILE",7) != 0 || h.version != tile_file_version){
+		cout << "Fichier de tuile " << tile_file << " invalide" << endl;
+		return 1;
+	}
+	point_cloud points;
+	vector<point> block(tile_block_size);
+	while(true){
+		f.read((char*)block.data(),block.size()*sizeof(point));
+		size_t nb = f.gcount()/sizeof(point);
+		if (nb == 0){
+			break;
+		}
+		for(size_t k = 0; k < nb; k++){
+			points.push_back(block[k]);
+		}
+	}
+	f.close();
+	string base = tile_file.substr(0,tile_file.rfind('.'));
+	size_t slash = tile_file.rfind('/');
+	string directory = (slash == string::npos) ? "." : tile_file.substr(0,slash);
+	cout << "Tile " << base << " : " << points.size() << " points" << endl;
+
+	//réduction des points sur la grille de l'image entière, les cases sont donc les mêmes dans toutes les tuiles
+	context["min_x"] = h.image_min_x;
+	context["max_x"] = h.image_max_x;
+	context["min_y"] = h.image_min_y;
+	context["max_y"] = h.image_max_y;
+	context["width"] = h.image_width;
+	context["height"] = h.image_height;
+	if (context["thinning"] != 0 && points.size() > 0){
+		thin_points(points,context); //(Voir thinning.cpp)
+	}
+
+	//emprise de la tuile
+	context["min_x"] = h.min_x;
+	context["max_x"] = h.max_x;
+	context["min_y"] = h.min_y;
+	context["max_y"] = h.max_y;
+	context["width"] = h.width;
+	context["height"] = h.height;
+	context["min_depth"] = h.min_depth;
+	context["max_depth"] = h.max_depth;
+
+	//triangulation, relue du cache à l'étape 2
+	set_tin_cache(directory+"/tin"); //(Voir tin_cache.cpp)
+	tin t;
+	if (points.size() >= 3){
+		triangulate(points,t,context); //(Voir triangulation.cpp)
+	}
+
+	//étape 1 : plus grands cotés des triangles comptés (voir statistics_radius) dont le centre est dans la tuile (et non dans sa marge),
+	//les bords communs de deux tuiles n'appartiennent qu'à l'une d'elles pour qu'aucun triangle ne soit compté deux fois
+	if (context["tile_stage"] == 1){
+		double sum = 0, sum_sq = 0, max_norm = 0, max_all = 0;
+		size_t count = 0;
+		bool last_column = (h.column+h.width == h.image_width);
+		bool first_row = (h.row == 0);
+		for(size_t i = 0; i < t.triangles.size(); i+=3){
+			point vertices[3] = {points[t.triangles[i]],points[t.triangles[i+1]],points[t.triangles[i+2]]};
+			double radius = triangle_circumradius(vertices); //sommets triés, centre indépendant de leur ordre (Voir triangulation.cpp)
+			double center_x = (vertices[0].x+vertices[1].x+vertices[2].x)/3;
+			double center_y = (vertices[0].y+vertices[1].y+vertices[2].y)/3;
+			if (center_x < h.min_x || center_x > h.max_x || (center_x == h.max_x && !last_column)
+				|| center_y < h.min_y || center_y > h.max_y || (center_y == h.max_y && !first_row)){
+				continue;
+			}
+			double norm_to_consider = 0;
+			for(int k = 0; k < 3; k++){
+				norm_to_consider = max(norm_to_consider,sqrt(pow(vertices[(k+1)%3].x-vertices[k].x,2)+pow(vertices[(k+1)%3].y-vertices[k].y,2)));
+			}
+			max_all = max(max_all,norm_to_consider);
+			if (radius > h.stats_radius){
+				continue;
+			}
+			sum += norm_to_consider;
+			sum_sq += pow(norm_to_consider,2);
+			max_norm = max(max_norm,norm_to_consider);
+			count++;
+		}
+		string stats_name = base+".stats";
+		ofstream stats(stats_name+".tmp");
+		stats << setprecision(17) << sum << " " << sum_sq << " " << max_norm << " " << max_all << " " << count << " " << context["thinning_cell"] << endl;
+		stats.close();
+		if (stats.fail() || rename((stats_name+".tmp").c_str(),stats_name.c_str()) != 0){
+			cout << "Echec d'écriture de " << stats_name << endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	//étape 2 : rendu de la tuile avec les pixels de l'image entière
+	if (!t.triangles.empty()){
+		keep_triangles(points,t,context["lim_triangle_lg"],context["nb_threads"],h.stats_radius); //(Voir triangulation.cpp)
+	}
+	vector<int> pixels;
+	vector<double> pixels_illumination;
+	create_pixels(pixels,pixels_illumination,context); //(Voir init_point_pixels.cpp)
+	context["lg_pix"] = h.lg_pix;
+	context["h_pix"] = h.h_pix;
+	if (!t.triangles.empty()){
+		color_triangles(points,t,pixels,pixels_illumination,context); //(Voir triangulation.cpp)
+	}
+	points.clear();
+	return (generate_image(pixels,pixels_illumination,context,base+".ppm") == 0) ? 1 : 0;
+}
+
+static void write_tiles(const string &spool_name, vector<tile_header> &headers, const vector<string> &names, int nb_columns, double halo){
+	/**
+	* \brief Écrit les fichiers de tuiles : entête puis points de la tuile et de sa marge, par blocs.
+	* \param spool_name fichier des points projetés.
+	* \param headers entêtes des tuiles, ligne par ligne.
+	* \param names noms des tuiles (sans extension).
+	* \param nb_columns nombre de tuiles par ligne.
+	* \param halo largeur de la marge en m.
+	*/
+	size_t nb_tiles = headers.size();
+	vector<ofstream> files(nb_tiles);
+	vector<vector<point>> buffers(nb_tiles);
+	for(size_t k = 0; k < nb_tiles; k++){
+		files[k].open(names[k]+".pts",ios::binary);
+		files[k].write((const char*)&headers[k],sizeof(tile_header));
+	}
+	ifstream spool(spool_name,ios::binary);
+	vector<point> block(tile_block_size);
+	vector<int> columns, rows;
+	while(true){
+		spool.read((char*)block.data(),block.size()*sizeof(point));
+		size_t nb = spool.gcount()/sizeof(point);
+		if (nb == 0){
+			break;
+		}
+		for(size_t p = 0; p < nb; p++){
+			const point &pt = block[p];
+			columns.clear();
+			rows.clear();
+			for(int j = 0; j < nb_columns; j++){
+				if (pt.x >= headers[j].min_x-halo && pt.x <= headers[j].max_x+halo){
+					columns.push_back(j);
+				}
+				if (pt.y >= headers[j*nb_columns].min_y-halo && pt.y <= headers[j*nb_columns].max_y+halo){
+					rows.push_back(j);
+				}
+			}
+			for(int i : rows){
+				for(int j : columns){
+					vector<point> &buffer = buffers[i*nb_columns+j];
+					buffer.push_back(pt);
+					if (buffer.size() == tile_block_size){
+						files[i*nb_columns+j].write((const char*)buffer.data(),buffer.size()*sizeof(point));
+						buffer.clear();
+					}
+				}
+			}
+		}
+	}
+	for(size_t k = 0; k < nb_tiles; k++){
+		files[k].write((const char*)buffers[k].data(),buffers[k].size()*sizeof(point));
+		files[k].close();
+	}
+}
+
+static int run_workers(const vector<vector<string>> &commands, const vector<string> &logs, int nb_parallel, const string &launcher){
+	/**
+	* \brief Lance les travailleurs, au plus nb_parallel à la fois, et attend leur fin.
+	* \param commands commande de chaque travailleur.
+	* \param logs fichier de sortie de chaque travailleur.
+	* \param nb_parallel nombre de travailleurs simultanés.
+	* \param launcher commande qui lance les travailleurs (voir spawn_worker).
+	* \return nombre de travailleurs en échec.
+	*/
+	map<pid_t,size_t> running;
+	size_t next = 0;
+	int nb_failed = 0;
+	while(next < commands.size() || !running.empty()){
+		if (next < commands.size() && int(running.size()) < nb_parallel){
+			pid_t pid = spawn_worker(commands[next],logs[next],next,launcher);
+			if (pid < 0){
+				cout << endl << "Echec du lancement du travailleur de la tuile " << next << endl;
+				nb_failed++;
+			}
+			else{
+				running[pid] = next;
+			}
+			next++;
+			continue;
+		}
+		int status;
+		pid_t pid = waitpid(-1,&status,0);
+		if (pid < 0){
+			break;
+		}
+		auto found = running.find(pid);
+		if (found == running.end()){
+			continue;
+		}
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+			cout << endl << "Echec du travailleur de la tuile " << found->second << " (voir " << logs[found->second] << ")" << endl;
+			nb_failed++;
+		}
+		running.erase(found);
+	}
+	return nb_failed;
+}
+
+static pid_t spawn_worker(const vector<string> &command, const string &log, size_t index, const string &launcher){
+	/**
+	* \brief Lance un travailleur, ses sorties sont ajoutées à son fichier de sortie.
+	* \param command commande du travailleur.
+	* \param log fichier de sortie.
+	* \param index numéro de la tuile, donné au travailleur dans la variable d'environnement TILE_INDEX.
+	* \param launcher si non vide, le travailleur est lancé par le shell avec "launcher commande"
+	* (par exemple "ssh noeud$((TILE_INDEX%4))" avec un dossier des tuiles partagé entre les machines).
+	* \return pid du processus lancé, -1 en cas d'échec.
+	*/
+	vector<string> args = command;
+	if (launcher != ""){
+		string line = launcher;
+		for(const string &arg : command){
+			line += " "+shell_quote(arg);
+		}
+		args = {"/bin/sh","-c",line};
+	}
+	vector<char*> argv;
+	for(string &arg : args){
+		argv.push_back(&arg[0]);
+	}
+	argv.push_back(nullptr);
+	vector<string> env;
+	for(char **variable = environ; *variable != nullptr; variable++){
+		env.push_back(*variable);
+	}
+	env.push_back("TILE_INDEX="+to_string(index));
+	vector<char*> envp;
+	for(string &variable : env){
+		envp.push_back(&variable[0]);
+	}
+	envp.push_back(nullptr);
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions,1,log.c_str(),O_WRONLY|O_CREAT|O_APPEND,0644);
+	posix_spawn_file_actions_adddup2(&actions,1,2);
+	pid_t pid;
+	int error = posix_spawn(&pid,argv[0],&actions,nullptr,argv.data(),envp.data());
+	posix_spawn_file_actions_destroy(&actions);
+	return (error == 0) ? pid : -1;
+}
+
+static int stitch_tiles(const vector<tile_header> &headers, const vector<string> &images, int width, int height, const string &image_name){
+	/**
+	* \brief Recopie les lignes des images des tuiles à leur place dans l'image entière.
+	* \param headers entêtes des tuiles (position et taille).
+	* \param images images des tuiles.
+	* \param width,height taille de l'image entière en pixels.
+	* \param image_name image à écrire.
+	* \return 1 si l'image a été écrite, 0 sinon.
+	*/
+	int fd = open(image_name.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+	if (fd < 0){
+		return 0;
+	}
+	string header = image_header(width,height); //(Voir generate_image.cpp)
+	bool ok = write(fd,header.data(),header.size()) == ssize_t(header.size())
+		&& ftruncate(fd,header.size()+3*size_t(width)*height) == 0;
+	for(size_t k = 0; k < headers.size() && ok; k++){
+		const tile_header &h = headers[k];
+		ifstream tile(images[k],ios::binary);
+		tile.seekg(image_header(h.width,h.height).size());
+		vector<char> row(3*size_t(h.width));
+		for(int r = 0; r < h.height && ok; r++){
+			ok = bool(tile.read(row.data(),row.size()));
+			off_t offset = header.size()+3*(size_t(h.row+r)*width+h.column);
+			ok = ok && pwrite(fd,row.data(),row.size(),offset) == ssize_t(row.size());
+		}
+	}
+	close(fd);
+	return ok ? 1 : 0;
+}
+
+static string executable_path(){
+	/**
+	* \brief Chemin du programme en cours, lancé par les travailleurs.
+	* \return chemin absolu de l'exécutable.
+	*/
+	char path[4096];
+	ssize_t size = readlink("/proc/self/exe",path,sizeof(path)-1);
+	return (size > 0) ? string(path,size) : string("create_raster");
+}
+
+static string shell_quote(const string &arg){
+	/**
+	* \brief Protège un argument pour le shell.
+	* \param arg argument.
+	* \return argument entre apostrophes.
+	*/
+	string quoted = "'";
+	for(char c : arg){
+		quoted += (c == '\'') ? string("'\\''") : string(1,c);
+	}
+	return quoted+"'";
+}
@@ -0,0 +1,21 @@
+#include <cstdlib>
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+
+#ifndef TILES_H
+#define TILES_H
+
+/**
+* \file tiles.h
+* \brief Fichier de déclaration du rendu distribué par tuiles : un coordinateur découpe l'emprise du relevé en tuiles,
+* des processus travailleurs triangulent et rendent chaque tuile avec une marge de points voisins, puis le coordinateur
+* assemble les images des tuiles.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int run_tiles(std::string file_name, std::map<std::string,double> &context, std::map<std::string,std::string> &paths, const std::vector<std::string> &options);
+int run_tile_worker(std::string tile_file, std::map<std::string,double> &context);
+
+#endif
@@ -0,0 +1,234 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "struct_point.h"
+#include "triangulation.h"
+#include "parallel.h"
+#include "tin_cache.h"
+
+/**
+* \file tin_cache.cpp
+* \brief Fichier d'implémentation du cache sur disque des triangulations.
+* Un nouveau rendu du même relevé (autre largeur, autre soleil...) relit les triangles, les demi-arêtes, la longueur maximale
+* d'un coté et les triangles conservés au lieu de les recalculer.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static uint64_t mix(uint64_t h);
+static uint64_t tin_key(point_cloud &points, map<string,double> &context);
+static string tin_file(uint64_t key);
+
+static string cache_directory; //dossier du cache, vide si le cache n'est pas utilisé
+static const size_t min_cached_points = 65536; //les petites triangulations (bords du mode accumulation...) sont recalculées
+static const uint32_t tin_cache_version = 2;
+
+struct tin_cache_header
+{
+	/**
+	* \brief Entête d'un fichier du cache, suivi des triangles, des demi-arêtes (nb_indices indices chacun)
+	* et des triangles conservés (nb_indices/3 octets).
+	* \param magic "CRTIN" pour reconnaitre le fichier.
+	* \param version version du format, un fichier d'une autre version est recalculé.
+	* \param index_size,coord_size tailles des types de la triangulation (voir struct_point.h).
+	* \param key empreinte des points triangulés et des paramètres de la sélection des triangles.
+	* \param nb_points nombre de points triangulés.
+	* \param nb_indices nombre d'indices des triangles.
+	* \param lim_triangle_lg longueur maximale d'un coté de triangle conservé.
+	* \param max_radius rayon maximal du cercle circonscrit d'un triangle conservé.
+	*/
+	char magic[8];
+	uint32_t version;
+	uint32_t index_size;
+	uint32_t coord_size;
+	uint32_t reserved;
+	uint64_t key;
+	uint64_t nb_points;
+	uint64_t nb_indices;
+	double lim_triangle_lg;
+	double max_radius;
+};
+
+void set_tin_cache(const string &directory){
+	/**
+	* \brief Choisit le dossier du cache des triangulations, utilisé ensuite par chaque triangulation (voir triangulate).
+	* \param directory dossier du cache, créé au premier enregistrement. Le cache n'est pas utilisé si vide.
+	*/
+	cache_directory = directory;
+}
+
+bool load_tin(point_cloud &points, tin &t, map<string,double> &context, uint64_t &key){
+	/**
+	* \brief Cherche la triangulation des points dans le cache. Le fichier est projeté en mémoire puis copié dans t.
+	* \param points Nuage de points à trianguler.
+	* \param t Triangulation remplie si elle est dans le cache.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise la taille des cases de la réduction des points (thinning_cell), qui change la sélection
+	* des triangles, et le nombre de threads (nb_threads) pour calculer l'empreinte.
+	* \param key Empreinte des points, à donner à save_tin si la triangulation n'est pas dans le cache (0 sans cache).
+	* \return true si la triangulation a été lue.
+	*/
+	key = 0;
+	if (cache_directory == "" || points.size() < min_cached_points){
+		return false;
+	}
+	time_t t0,tf;
+	time(&t0);
+	key = tin_key(points,context);
+	string file_name = tin_file(key);
+	int fd = open(file_name.c_str(),O_RDONLY);
+	if (fd < 0){
+		return false;
+	}
+	struct stat file_stat;
+	size_t file_size = (fstat(fd,&file_stat) == 0) ? file_stat.st_size : 0;
+	bool loaded = false;
+	void *map = (file_size >= sizeof(tin_cache_header)) ? mmap(nullptr,file_size,PROT_READ,MAP_PRIVATE,fd,0) : MAP_FAILED;
+	if (map != MAP_FAILED){
+		const tin_cache_header *header = (const tin_cache_header*)map;
+		size_t nb = header->nb_indices;
+		if (memcmp(header->magic,"CRTIN",6) == 0 && header->version == tin_cache_version
+			&& header->index_size == sizeof(tin_index) && header->coord_size == sizeof(tin_coord)
+			&& header->key == key && header->nb_points == points.size()
+			&& file_size == sizeof(tin_cache_header)+2*nb*sizeof(tin_index)+nb/3){
+			cout << "- Loading triangulation from cache...";
+			const tin_index *triangles = (const tin_index*)(header+1);
+			const tin_index *halfedges = triangles+nb;
+			const char *kept = (const char*)(halfedges+nb);
+			t.triangles.assign(triangles,triangles+nb);
+			t.halfedges.assign(halfedges,halfedges+nb);
+			t.kept.assign(kept,kept+nb/3);
+			t.lim_triangle_lg = header->lim_triangle_lg;
+			t.max_radius = header->max_radius;
+			t.vertex_normals.clear();
+			loaded = true;
+			time(&tf);
+			cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+		}
+		munmap(map,file_size);
+	}
+	close(fd);
+	return loaded;
+}
+
+void save_tin(const tin &t, size_t nb_points, uint64_t key){
+	/**
+	* \brief Enregistre une triangulation dans le cache. Le fichier est écrit sous un nom temporaire puis renommé,
+	* un autre processus ne lit donc jamais un fichier incomplet.
+	* \param t Triangulation avec ses demi-arêtes et ses triangles conservés (voir triangulate).
+	* \param nb_points Nombre de points triangulés.
+	* \param key Empreinte des points donnée par load_tin, rien n'est enregistré si elle vaut 0.
+	*/
+	if (key == 0 || cache_directory == ""){
+		return;
+	}
+	time_t t0,tf;
+	time(&t0);
+	cout << "- Saving triangulation to cache...";
+	mkdir(cache_directory.c_str(),0755); //le dossier peut déjà exister
+	string file_name = tin_file(key);
+	string temp_name = file_name+"."+to_string(getpid());
+
+	tin_cache_header header;
+	memset(&header,0,sizeof(header));
+	memcpy(header.magic,"CRTIN",6);
+	header.version = tin_cache_version;
+	header.index_size = sizeof(tin_index);
+	header.coord_size = sizeof(tin_coord);
+	header.key = key;
+	header.nb_points = nb_points;
+	header.nb_indices = t.triangles.size();
+	header.lim_triangle_lg = t.lim_triangle_lg;
+	header.max_radius = t.max_radius;
+
+	ofstream f(temp_name,ios::binary);
+	f.write((const char*)&header,sizeof(header));
+	f.write((const char*)t.triangles.data(),t.triangles.size()*sizeof(tin_index));
+	f.write((const char*)t.halfedges.data(),t.halfedges.size()*sizeof(tin_index));
+	f.write(t.kept.data(),t.kept.size());
+	f.close();
+	if (!f || t.halfedges.size() != t.triangles.size() || rename(temp_name.c_str(),file_name.c_str()) != 0){
+		cout << " Echec d'écriture de " << file_name;
+		unlink(temp_name.c_str());
+	}
+	time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+}
+
+static uint64_t tin_key(point_cloud &points, map<string,double> &context){
+	/**
+	* \brief Calcule l'empreinte sur 64 bits des coordonnées des points (par blocs en parallèle, indépendante du nombre de threads)
+	* et des paramètres qui changent la triangulation enregistrée.
+	* \param points Nuage de points.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \return Empreinte, jamais nulle.
+	*/
+	const size_t block_size = 65536;
+	size_t nb_coords = points.coords.size();
+	size_t nb_blocks = (nb_coords+block_size-1)/block_size;
+	vector<uint64_t> blocks(nb_blocks);
+	parallel_for(nb_blocks,context["nb_threads"],[&](size_t begin, size_t end, int){
+		for(size_t b = begin; b < end; b++){
+			uint64_t h = b;
+			for(size_t i = b*block_size; i < min(nb_coords,(b+1)*block_size); i++){
+				uint64_t word;
+				memcpy(&word,&points.coords[i],sizeof(word));
+				h = mix(h^word);
+			}
+			blocks[b] = h;
+		}
+	});
+
+	double parameters[] = {double(points.size()),context["thinning_cell"],statistics_radius(context,points.size()),double(sizeof(tin_index)),double(sizeof(tin_coord)),
+#ifdef CREATE_RASTER_FLOAT_COORDS
+		context["min_x"],context["min_y"], //origine des coordonnées float
+#endif
+	};
+	uint64_t key = tin_cache_version;
+	for(double parameter : parameters){
+		uint64_t word;
+		memcpy(&word,&parameter,sizeof(word));
+		key = mix(key^word);
+	}
+	for(uint64_t h : blocks){
+		key = mix(key^h);
+	}
+	return (key == 0) ? 1 : key;
+}
+
+static uint64_t mix(uint64_t h){
+	/**
+	* \brief Mélange les bits d'un entier sur 64 bits (finaliseur de splitmix64).
+	* \param h entier à mélanger.
+	* \return entier mélangé.
+	*/
+	h += 0x9e3779b97f4a7c15ULL;
+	h = (h^(h>>30))*0xbf58476d1ce4e5b9ULL;
+	h = (h^(h>>27))*0x94d049bb133111ebULL;
+	return h^(h>>31);
+}
+
+static string tin_file(uint64_t key){
+	/**
+	* \brief Chemin du fichier du cache d'une empreinte.
+	* \param key empreinte des points.
+	* \return dossier/empreinte.tin
+	*/
+	ostringstream name;
+	name << cache_directory << "/" << hex << setw(16) << setfill('0') << key << ".tin";
+	return name.str();
+}
@@ -0,0 +1,22 @@
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <map>
+#include "struct_point.h"
+#include "triangulation.h"
+
+#ifndef TIN_CACHE_H
+#define TIN_CACHE_H
+
+/**
+* \file tin_cache.h
+* \brief Fichier de déclaration du cache sur disque des triangulations, identifiées par une empreinte des points triangulés.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+void set_tin_cache(const std::string &directory);
+bool load_tin(point_cloud &points, tin &t, std::map<std::string,double> &context, std::uint64_t &key);
+void save_tin(const tin &t, std::size_t nb_points, std::uint64_t key);
+
+#endif
@@ -3,10 +3,25 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include <cmath>
 #include "delaunator.hpp"
 #include "Triangle.h"
 #include "triangulation.h"
 #include "struct_point.h"
+#include "shading.h"
+#include "parallel.h"
+#include "simplification.h"
+#include "mesh_export.h"
+#include "contours.h"
+#include "bands.h"
+#include "sparse.h"
+#include "memory.h"
+#include "init_points_pixels.h"
+#include "tin_cache.h"
+#include "progressive.h"
 
 using namespace std;
 
@@ -17,6 +32,15 @@ using namespace std;
 * \author NOEL Océan
 */
 
+static const double stats_radius_factor = 16; //rayon maximal des triangles comptés et conservés, en espacements moyens des points
+
+//canaux écrits par fill_pixels, choisis à la compilation (voir pixel_channels)
+enum {channel_depth = 1, channel_slope = 2, channel_aspect = 4, channel_rugosity = 8, channel_triangle = 16, nb_channel_sets = 32};
+template <int channels>
+static void fill_pixels(Triangle &T, vector<int> &pixels, vector<double> &pixels_illumination, normal_buffer *pixels_normals, pixel_channels *out);
+template <int channels>
+static void dispatch_pixels(int mask, Triangle &T, vector<int> &pixels, vector<double> &pixels_illumination, normal_buffer *pixels_normals, pixel_channels *out);
+
 double width;
 double height;
 double default_color;
@@ -30,24 +54,14 @@ int nb_colors;
 double min_depth;
 double max_depth;
 
-void triangulate_n_color(vector<point> &points, vector<double> &points_line,vector<int> &pixels, vector<double> &pixels_illumination,map<string,double> &context){
+void set_raster_parameters(map<string,double> &context){
 	/**
-	* \brief Calcul les triangles de delaunay et en déduit une coloration pour les pixels.
-	* \param points_line Coordonnées des points en m sous forme {x0,y0,x1,y1...}.
-	* \param pixels Liste des pixels.
-	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \brief Initialise les variables globales utilisées pour placer et colorer les pixels (voir pixel_of_point, find_pixels et convert_to_color).
 	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
-	* Ici cette fonction en a besoin pour appeler ses fonction auxilliaires et elle utilise : 
-	* - le vecteur lumière qui génère les ombres (sun_dir_x,sun_dir_y,sun_dir_z)
+	* Ici cette fonction utilise la taille de l'image (width,height,lg_pix,h_pix), ses limites (min_x,max_x,min_y,max_y),
+	* la couleur par défaut (default_color) et l'échantillonage de la colormap (nb_colors,min_depth,max_depth).
 	*/
 
-	//variables analytiques
-	time_t t0,tf; 
-	cout << endl<<"Triangulation and coloration :"<<endl<<"- Creating Triangles...";
-	time(&t0);
-	int progress = 0;
-
-	//récupération des variables nécessaires
 	width = context["width"];
 	height = context["height"];
 	default_color = context["default_color"];
@@ -60,16 +74,152 @@ void triangulate_n_color(vector<point> &points, vector<double> &points_line,vect
 	nb_colors = context["nb_colors"];
 	min_depth = context["min_depth"];
 	max_depth = context["max_depth"];
-	double sun_dir_x = context["sun_dir_x"];
-	double sun_dir_y = context["sun_dir_y"];
-	double sun_dir_z = context["sun_dir_z"];
+}
+
+void triangulate_n_color(point_cloud &points, vector<int> &pixels, vector<double> &pixels_illumination,map<string,double> &context, const string &mesh_file, pixel_channels *channels, const string &contour_file, const string &band_image, const string &preview_image){
+	/**
+	* \brief Calcul les triangles de delaunay et en déduit une coloration pour les pixels.
+	* \param points Nuage de points projetés.
+	* \param pixels Liste des pixels, créés ici après la triangulation s'ils sont vides (voir create_pixels).
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction en a besoin pour appeler ses fonction auxilliaires (voir triangulate et color_triangles),
+	* et utilise les niveaux de détail si lod vaut 1 (voir build_lods).
+	* \param mesh_file Fichier où exporter la triangulation rendue (voir export_mesh), aucun export si vide.
+	* \param channels Canaux des pixels à remplir (profondeur, pente..., voir pixel_channels), ignorés si nullptr.
+	* \param contour_file Fichier où écrire les isobathes de la triangulation complète (voir export_contours), aucun si vide.
+	* \param band_image Image écrite au fur et à mesure du rendu, par tuiles creuses si sparse_tile est donné (voir render_sparse)
+	* ou par bandes si band_rows est donné (voir render_bands), les pixels ne sont alors pas créés. Si vide, toute l'image est rendue dans pixels.
+	* \param preview_image Image où écrire les aperçus du rendu progressif si progressive est donné (voir render_previews).
+	*/
+
+	cout << endl<<"Triangulation and coloration :"<<endl;
+	tin t;
+	triangulate(points,t,context);
+	memory_stage("triangulation",context); //(Voir memory.cpp)
+	if (contour_file != ""){
+		export_contours(contour_file,points,t,context); //(Voir contours.cpp)
+	}
+	bool sparse = band_image != "" && use_sparse(context,channels); //(Voir sparse.cpp)
+	bool banded = !sparse && band_image != "" && use_bands(context); //(Voir bands.cpp)
+	if (pixels.empty() && !banded && !sparse){ //pixels créés une fois delaunator libéré, pour ne pas cumuler leurs mémoires
+		create_pixels(pixels,pixels_illumination,context);
+	}
+
+	//niveau de détail adapté à la taille des pixels (voir simplification.cpp)
+	if (context["lod"] == 1){
+		double pixel_size = max(context["lg_pix"],context["h_pix"]);
+		vector<lod_level> lods;
+		build_lods(points,t,context,lods,pixel_size);
+		lod_level* level = select_lod(lods,pixel_size);
+		if (level != nullptr){
+			cout << "- Using level of detail with " << level->points.size() << " vertices" << endl;
+			t = tin(); //la triangulation complète ne sert plus
+			index_vector().swap(level->t.halfedges);
+			memory_stage("lod",context);
+			if (mesh_file != ""){
+				export_mesh(mesh_file,level->points,level->t,context);
+			}
+			if (preview_image != "" && context["progressive"] > 0){
+				render_previews(level->points,level->t,context,preview_image); //(Voir progressive.cpp)
+			}
+			if (sparse){
+				render_sparse(level->points,level->t,context,band_image);
+			}
+			else if (banded){
+				render_bands(level->points,level->t,context,channels,band_image);
+			}
+			else{
+				color_triangles(level->points,level->t,pixels,pixels_illumination,context,nullptr,nullptr,channels);
+			}
+			return;
+		}
+	}
+	if (mesh_file != ""){
+		export_mesh(mesh_file,points,t,context);
+	}
+	index_vector().swap(t.halfedges); //les demi-arêtes ne servent pas au rendu, libérées avant la coloration
+	if (preview_image != "" && context["progressive"] > 0){
+		render_previews(points,t,context,preview_image); //(Voir progressive.cpp)
+	}
+	if (sparse){
+		render_sparse(points,t,context,band_image);
+	}
+	else if (banded){
+		render_bands(points,t,context,channels,band_image);
+	}
+	else{
+		color_triangles(points,t,pixels,pixels_illumination,context,nullptr,nullptr,channels);
+	}
+}
+
+template <typename Coords>
+static void delaunay(const Coords &coords, tin &t){
+	/**
+	* \brief Triangule des coordonnées {x0,y0,x1,y1...} avec delaunator et garde les triangles et demi-arêtes.
+	* L'objet delaunator (enveloppe convexe, table de hachage) est libéré en sortie.
+	* \param coords Coordonnées des points.
+	* \param t Triangulation dans laquelle stocker les triangles et demi-arêtes.
+	*/
+	delaunator::Delaunator<tin_index,typename Coords::value_type,index_vector::allocator_type,typename Coords::allocator_type> d(coords);
+	t.triangles = move(d.triangles);
+	t.halfedges = move(d.halfedges);
+}
+
+void triangulate(point_cloud &points, tin &t, map<string,double> &context, double lim_triangle_lg, double max_radius){
+	/**
+	* \brief Calcul les triangles de delaunay et sélectionne ceux à conserver pour les formes non convexes.
+	* \param points Nuage de points, delaunator lit directement ses coordonnées {x0,y0,x1,y1...} (sans copie),
+	* sauf avec des coordonnées float (tin_coord, voir struct_point.h) qui sont alors copiées par rapport au coin du relevé.
+	* \param t Triangulation dans laquelle stocker les triangles, demi-arêtes et triangles conservés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise le nombre de threads (nb_threads), la taille des cases de la réduction des points (thinning_cell)
+	* et les paramètres du rayon maximal des triangles conservés (voir statistics_radius).
+	* La triangulation est relue du cache si elle y est, et y est enregistrée sinon (voir set_tin_cache).
+	* \param lim_triangle_lg Longueur maximale d'un coté de triangle si elle est déjà connue (voir watch.cpp),
+	* calculée d'après les triangles si 0. Le cache n'est pas utilisé quand elle est donnée.
+	* \param max_radius Rayon maximal du cercle circonscrit d'un triangle conservé quand lim_triangle_lg est donnée, 0 sans limite.
+	*/
+
+	//triangulation déjà calculée pour ces points (voir tin_cache.cpp)
+	uint64_t cache_key = 0;
+	if (lim_triangle_lg == 0 && load_tin(points,t,context,cache_key)){
+		return;
+	}
+
+	//variables analytiques
+	time_t t0,tf; 
+	cout << "- Creating Triangles...";
+	time(&t0);
+	int progress = 0;
+	int nb_threads = context["nb_threads"];
 
 	//calcul des triangles sous forme {x0,y0,x1,y1,x2,y2}
-	delaunator::Delaunator d(points_line);
+	if (points.size() > (no_halfedge-1)/6){
+		throw runtime_error("trop de points pour des indices de triangulation sur 32 bits (compiler avec CREATE_RASTER_64BIT_INDICES)");
+	}
+#ifdef CREATE_RASTER_FLOAT_COORDS
+	//coordonnées rebasées sur le coin du relevé, petites et donc précises en float
+	vector<tin_coord,counting_allocator<tin_coord,memory_triangulation>> local_coords(points.coords.size());
+	double origin[2] = {context["min_x"],context["min_y"]};
+	parallel_for(points.size(),nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = 2*begin; i < 2*end; i++){
+			local_coords[i] = points.coords[i]-origin[i%2];
+		}
+	});
+	delaunay(local_coords,t);
+#else
+	delaunay(points.coords,t);
+#endif
 
 	time(&tf);
 	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
 
+	//longueur maximale déjà connue
+	if (lim_triangle_lg > 0){
+		keep_triangles(points,t,lim_triangle_lg,nb_threads,max_radius);
+		return;
+	}
 
 	/////////////////////////////////////////////
 	////Optimisation pour les formes non convex//
@@ -78,21 +228,23 @@ void triangulate_n_color(vector<point> &points, vector<double> &points_line,vect
 	//détermination de la longueur maximale d'un coté de triangle à avoir
 	cout << "- Optimizing triangles for non-convex forms...";
 	time(&t0);
-	size_t nb_triangles = d.triangles.size();
-	double lim_triangle_lg = 0;
+	size_t nb_triangles = t.triangles.size();
 	double mean = 0;
 	double ecar_type = 0; 
 	double max_norm = 0;
 	double min_norm = 9999999;
+	max_radius = statistics_radius(context,points.size());
+	size_t nb_counted = 0;
+	double max_all = 0; //plus grand coté de tous les triangles, si aucun n'est compté
 
 	for(std::size_t i = 0; i < nb_triangles; i+=3) {
     	//données de delaunator
-    	double x0 = d.coords[2 * d.triangles[i]];
-    	double y0 = d.coords[2 * d.triangles[i] + 1]; 
-    	double x1 = d.coords[2 * d.triangles[i + 1]];
-    	double y1 = d.coords[2 * d.triangles[i + 1] + 1];
-    	double x2 = d.coords[2 * d.triangles[i + 2]];
-    	double y2 = d.coords[2 * d.triangles[i + 2] + 1]; 
+    	double x0 = points.x(t.triangles[i]);
+    	double y0 = points.y(t.triangles[i]);
+    	double x1 = points.x(t.triangles[i + 1]);
+    	double y1 = points.y(t.triangles[i + 1]);
+    	double x2 = points.x(t.triangles[i + 2]);
+    	double y2 = points.y(t.triangles[i + 2]);
 
     	//calcul de la taille des segments
     	vector<double> v1 = {x1-x0,y1-y0}; 
@@ -102,8 +254,15 @@ void triangulate_n_color(vector<point> &points, vector<double> &points_line,vect
 		double norm2 = sqrt(pow(v2[0],2)+pow(v2[1],2));
 		double norm3 = sqrt(pow(v3[0],2)+pow(v3[1],2));
 
-		//on considère uniquement le segment le plus grand
+		//on considère uniquement le segment le plus grand, des triangles dont le cercle circonscrit est assez petit
+		//(les grands triangles qui comblent l'enveloppe convexe et les creux du relevé ne sont pas comptés)
 		double norm_to_consider = max({norm1,norm2,norm3});
+		max_all = max(max_all,norm_to_consider);
+		point vertices[3] = {points[t.triangles[i]],points[t.triangles[i + 1]],points[t.triangles[i + 2]]};
+		if (triangle_circumradius(vertices) > max_radius){
+			continue;
+		}
+		nb_counted++;
 
 		//ajout pour futur calcul de la moyenne et ecart_type
 		mean += norm_to_consider;
@@ -122,19 +281,164 @@ void triangulate_n_color(vector<point> &points, vector<double> &points_line,vect
 
     }
 
+    //longueur maximale d'un coté de triangle d'après la moyenne et l'écart-type des plus grands segments de triangles,
+    //tous les triangles sont conservés si aucun n'a été compté
+    if (nb_counted == 0){
+        max_norm = max_all;
+        max_radius = 0;
+    }
+    lim_triangle_lg = triangle_length_limit(mean,ecar_type,max_norm,nb_counted,context["thinning_cell"]);
+
+    time(&tf);
+	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+
+	//sélection des triangles conservés
+	keep_triangles(points,t,lim_triangle_lg,nb_threads,max_radius);
+	save_tin(t,points.size(),cache_key);
+}
+
+double statistics_radius(map<string,double> &context, size_t nb_points){
+	/**
+	* \brief Rayon maximal du cercle circonscrit des triangles comptés dans les statistiques de la longueur maximale
+	* d'un coté de triangle (voir triangulate) et des triangles conservés (voir keep_triangles) : stats_radius_factor fois
+	* l'espacement moyen des points sur l'emprise du relevé, ou la taille des cases de la réduction des points si elle est plus grande.
+	* Il ne dépend que du relevé entier, le rendu par tuiles compte et conserve donc les mêmes triangles (voir tiles.cpp).
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise les limites du nuage de points, la taille de l'image, le nombre de points lus (nb_points)
+	* et la réduction des points (thinning,thinning_tolerance).
+	* \param nb_points nombre de points triangulés, utilisé si nb_points n'est pas donné dans context.
+	* \return rayon en m.
+	*/
+	double ext_x = context["max_x"]-context["min_x"];
+	double ext_y = context["max_y"]-context["min_y"];
+	double nb = (context["nb_points"] > 0) ? context["nb_points"] : double(nb_points);
+	double spacing = sqrt(ext_x*ext_y/max(nb,1.0));
+	if (context["thinning"] != 0){
+		spacing = max(spacing,context["thinning_tolerance"]*min(ext_x/context["width"],ext_y/context["height"]));
+	}
+	return stats_radius_factor*spacing;
+}
+
+double triangle_circumradius(point *vertices){
+	/**
+	* \brief Rayon du cercle circonscrit d'un triangle. Les sommets sont d'abord triés par coordonnées pour que le calcul
+	* (et le centre (v0+v1+v2)/3 calculé ensuite par l'appelant) ne dépende pas de l'ordre des sommets dans la triangulation.
+	* \param vertices les trois sommets du triangle, triés en place.
+	* \return rayon en m, infini pour un triangle plat.
+	*/
+	sort(vertices,vertices+3,[](const point &a, const point &b){ return a.x < b.x || (a.x == b.x && a.y < b.y); });
+	double a = sqrt(pow(vertices[1].x-vertices[0].x,2)+pow(vertices[1].y-vertices[0].y,2));
+	double b = sqrt(pow(vertices[2].x-vertices[1].x,2)+pow(vertices[2].y-vertices[1].y,2));
+	double c = sqrt(pow(vertices[0].x-vertices[2].x,2)+pow(vertices[0].y-vertices[2].y,2));
+	double area2 = abs((vertices[1].x-vertices[0].x)*(vertices[2].y-vertices[0].y)-(vertices[1].y-vertices[0].y)*(vertices[2].x-vertices[0].x));
+	if (area2 == 0){
+		return numeric_limits<double>::infinity();
+	}
+	return a*b*c/(2*area2);
+}
+
+double triangle_length_limit(double sum, double sum_sq, double max_norm, size_t nb, double thinning_cell){
+	/**
+	* \brief Calcule la longueur maximale d'un coté de triangle conservé à partir des plus grands cotés des triangles.
+	* \param sum somme des plus grands cotés des triangles.
+	* \param sum_sq somme de leurs carrés.
+	* \param max_norm plus grand coté (de tous les triangles si aucun n'est compté).
+	* \param nb nombre de triangles comptés (voir statistics_radius).
+	* \param thinning_cell taille des cases de la réduction des points (voir thin_points), 0 sans réduction.
+	* \return longueur maximale en m.
+	*/
+
+    //aucun triangle compté : tous les triangles sont conservés
+    if (nb == 0){
+        return max_norm+1;
+    }
+
     //calcul de la moyenne et de l'écart-type des plus grands segments de triangles
-    mean = mean/(nb_triangles/3);
-    ecar_type = sqrt(ecar_type/(nb_triangles/3)-pow(mean,2));
+    double mean = sum/nb;
+    double ecar_type = sqrt(sum_sq/nb-pow(mean,2));
 
     //calcul de l'ecart_type relatif à la moyenne
     double relative_std = abs(ecar_type/mean);
 
     //définition de la longeur maximale pour un coté de triangle
-    lim_triangle_lg = min(max_norm+1,(1+(1/relative_std))*mean);
+    double lim_triangle_lg = min(max_norm+1,(1+(1/relative_std))*mean);
 
-    time(&tf);
-	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
+    //après réduction des points (thinning.cpp), deux points de cases voisines peuvent être distants de 2*sqrt(2) cases
+    return min(max_norm+1,max(lim_triangle_lg,2*sqrt(2)*thinning_cell));
+}
 
+void keep_triangles(point_cloud &points, tin &t, double lim_triangle_lg, int nb_threads, double max_radius){
+	/**
+	* \brief Sélectionne les triangles conservés, ceux dont aucun coté n'est plus long que lim_triangle_lg
+	* et dont le cercle circonscrit n'est pas plus grand que max_radius : les fins triangles du bord des grands creux
+	* ne sont pas rendus, ce qui permet au rendu par tuiles de rendre exactement les mêmes triangles (voir tiles.cpp).
+	* \param points Points de la triangulation.
+	* \param t Triangulation, ses triangles conservés et sa longueur maximale sont remplacés.
+	* \param lim_triangle_lg Longueur maximale d'un coté de triangle.
+	* \param nb_threads Nombre de threads.
+	* \param max_radius Rayon maximal du cercle circonscrit d'un triangle (voir statistics_radius), 0 sans limite.
+	*/
+	vector<char> kept(t.triangles.size()/3);
+	parallel_for(kept.size(),nb_threads,[&](size_t begin, size_t end, int){
+		for(size_t i = begin; i < end; i++){
+			kept[i] = !triangle_too_long(points.coords,t.triangles,3*i,lim_triangle_lg);
+			if (kept[i] && max_radius > 0){
+				point vertices[3] = {points[t.triangles[3*i]],points[t.triangles[3*i+1]],points[t.triangles[3*i+2]]};
+				kept[i] = (triangle_circumradius(vertices) <= max_radius);
+			}
+		}
+	});
+
+	//sauvegarde de la sélection
+	t.kept = move(kept);
+	t.lim_triangle_lg = lim_triangle_lg;
+	t.max_radius = max_radius;
+	t.vertex_normals.clear();
+}
+
+void color_triangles(point_cloud &points, tin &t, vector<int> &pixels, vector<double> &pixels_illumination, map<string,double> &context, const vector<size_t> *selection, normal_buffer *pixels_normals, pixel_channels *channels){
+	/**
+	* \brief Colore les pixels à partir des triangles conservés d'une triangulation, puis calcul les ombrages.
+	* \param points Points de la triangulation.
+	* \param t Triangulation à utiliser.
+	* \param pixels Liste des pixels.
+	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param selection Indices des triangles à considérer (tous les triangles si nullptr).
+	* \param pixels_normals Normales des pixels déjà colorés pour l'ombrage lisse (voir binning.cpp), un buffer vide est utilisé si nullptr.
+	* \param channels Canaux des pixels (profondeur, pente..., voir pixel_channels), écrits en même temps que leur couleur, ignorés si nullptr.
+	* Ici cette fonction en a besoin pour appeler ses fonction auxilliaires et elle utilise : 
+	* - le vecteur lumière qui génère les ombres (sun_dir_x,sun_dir_y,sun_dir_z)
+	* - le mode d'ombrage (shading : 0 = par triangle, 1 = lisse multi-directionnel)
+	* - le calcul des ombres portées (shadows)
+	* - le nombre de threads (nb_threads)
+	*/
+
+	//variables analytiques
+	time_t t0,tf; 
+	int progress = 0;
+
+	//récupération des variables nécessaires
+	set_raster_parameters(context);
+	double sun_dir_x = context["sun_dir_x"];
+	double sun_dir_y = context["sun_dir_y"];
+	double sun_dir_z = context["sun_dir_z"];
+	bool smooth_shading = context["shading"] == 1;
+	int nb_threads = context["nb_threads"];
+
+	//normales aux sommets pour l'ombrage lisse (calculées une seule fois par triangulation)
+	normal_buffer own_normals;
+	if (smooth_shading){
+		if (t.vertex_normals.empty()){
+			compute_vertex_normals(points,t.triangles,t.kept,t.vertex_normals,nb_threads);
+		}
+		if (pixels_normals == nullptr){
+			own_normals.x.assign(pixels.size(),0);
+			own_normals.y.assign(pixels.size(),0);
+			own_normals.z.assign(pixels.size(),0);
+			pixels_normals = &own_normals;
+		}
+	}
 
 	/////////////////////////////////////////////////////
 	////Generation des triangles optimisés et coloration//
@@ -144,50 +448,42 @@ void triangulate_n_color(vector<point> &points, vector<double> &points_line,vect
 	cout << "- Generating new triangles and coloration...";
     time(&t0);
 	progress = 0;
-    for(std::size_t i = 0; i < nb_triangles; i+=3) {
-    	//données de delaunator
-    	double x0 = d.coords[2 * d.triangles[i]];
-    	double y0 = d.coords[2 * d.triangles[i] + 1]; 
-    	double x1 = d.coords[2 * d.triangles[i + 1]];
-    	double y1 = d.coords[2 * d.triangles[i + 1] + 1];
-    	double x2 = d.coords[2 * d.triangles[i + 2]];
-    	double y2 = d.coords[2 * d.triangles[i + 2] + 1]; 
+	size_t nb_triangles = (selection == nullptr) ? t.triangles.size() : 3*selection->size();
+    for(std::size_t k = 0; k < nb_triangles; k+=3) {
+    	size_t i = (selection == nullptr) ? k : 3*(*selection)[k/3]; //indice du triangle dans la triangulation
 
     	//si un des segments du triangle est trop long, on ignore ce triangle,
     	//cela permet d'avoir des contours mieux définit pour des formes non convexes.
-
-    	//calcul de la taille des segments
-    	vector<double> v1 = {x1-x0,y1-y0}; 
-		vector<double> v2 = {x2-x1,y2-y1}; 
-		vector<double> v3 = {x0-x2,y0-y2}; 
-		double norm1 = sqrt(pow(v1[0],2)+pow(v1[1],2));
-		double norm2 = sqrt(pow(v2[0],2)+pow(v2[1],2));
-		double norm3 = sqrt(pow(v3[0],2)+pow(v3[1],2));
-
-		bool too_long = (norm1 > lim_triangle_lg) || (norm2 > lim_triangle_lg) ||(norm3 > lim_triangle_lg);
-
-    	if (!too_long){ //si le triangle est trop grand, on l'ignore et on passe au suivant
+    	if (t.kept[i/3]){ //si le triangle est trop grand, on l'ignore et on passe au suivant
 
     		//points correspondants aux données delaunator
 
-	    	point* p1 = &(points[d.triangles[i]]);
-	    	point* p2 = &(points[d.triangles[i + 1]]);
-	    	point* p3 = &(points[d.triangles[i + 2]]);
+	    	point p1 = points[t.triangles[i]];
+	    	point p2 = points[t.triangles[i + 1]];
+	    	point p3 = points[t.triangles[i + 2]];
 
 	    	//création du triangle sous forme {p1,p2,p3} (liste de points)
 			Triangle T = Triangle(p1,p2,p3);
-			//cout << "Triangle points: [["<< T.p1->x<<", "<< T.p1->y<<"], ["<< T.p2->x<<", "<< T.p2->y<<"], ["<< T.p3->x<<", "<< T.p3->y<< "]]"<<endl;
+			T.index = i/3;
+			//cout << "Triangle points: [["<< T.p1.x<<", "<< T.p1.y<<"], ["<< T.p2.x<<", "<< T.p2.y<<"], ["<< T.p3.x<<", "<< T.p3.y<< "]]"<<endl;
 
 			//calcul de l'illumination de ce triangle
 			vector<double> sun_dir = {sun_dir_x,sun_dir_y,sun_dir_z};
 			T.compute_illumination(sun_dir);
 
+			//normales aux sommets pour l'ombrage lisse
+			if (smooth_shading){
+				T.n1 = &(t.vertex_normals[3*t.triangles[i]]);
+				T.n2 = &(t.vertex_normals[3*t.triangles[i + 1]]);
+				T.n3 = &(t.vertex_normals[3*t.triangles[i + 2]]);
+			}
+
 	    	//récupération des indices des pixels qui sont dans ce triangle et coloration
-	    	find_pixels(T,pixels,pixels_illumination);
+	    	find_pixels(T,pixels,pixels_illumination,smooth_shading ? pixels_normals : nullptr,channels);
     	}
 
     	//Affichage de la progression
-		progress = 100*i/(nb_triangles);
+		progress = 100*k/(nb_triangles);
 		string progress_str = to_string(progress);
 		cout << progress_str << " %";
 		cout << "\b\b";
@@ -199,15 +495,140 @@ void triangulate_n_color(vector<point> &points, vector<double> &points_line,vect
 	time(&tf);
 	cout<<" ("<<tf-t0<<" s)"<<endl; //affichage du temps d'éxecution
 
+	//ombrage lisse à partir des normales interpolées
+	if (smooth_shading){
+		compute_smooth_illumination(*pixels_normals,pixels_illumination,context);
+	}
+
+	//ombres portées par le relief
+	if (context["shadows"] == 1){
+		compute_cast_shadows(pixels,pixels_illumination,context);
+	}
+}
+
+void build_triangle_grid(point_cloud &points, tin &t, map<string,double> &context, triangle_grid &grid){
+	/**
+	* \brief Construit l'index spatial des triangles conservés, pour ne parcourir que les triangles d'une fenêtre lors d'un rendu.
+	* \param points Points de la triangulation.
+	* \param t Triangulation à indexer.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction à besoin des limites du nuage de points (min_x,max_x,min_y,max_y).
+	* \param grid Index dans lequel ranger les triangles.
+	*/
+	double ext_x = context["max_x"]-context["min_x"];
+	double ext_y = context["max_y"]-context["min_y"];
+	size_t nb_triangles = t.triangles.size()/3;
+
+	//cases de la taille des plus grands triangles, avec au plus une case par triangle
+	grid.min_x = context["min_x"];
+	grid.min_y = context["min_y"];
+	grid.cell = max({t.lim_triangle_lg,sqrt(ext_x*ext_y/max<size_t>(nb_triangles,1)),1e-9});
+	grid.nb_x = int(ext_x/grid.cell)+1;
+	grid.nb_y = int(ext_y/grid.cell)+1;
+	grid.cells.assign(size_t(grid.nb_x)*grid.nb_y,vector<size_t>());
+
+	for(size_t i = 0; i < nb_triangles; i++){
+		if (!t.kept[i]){
+			continue;
+		}
+		point p1 = points[t.triangles[3*i]];
+		point p2 = points[t.triangles[3*i+1]];
+		point p3 = points[t.triangles[3*i+2]];
+		int cx = min(grid.nb_x-1,max(0,int(((p1.x+p2.x+p3.x)/3-grid.min_x)/grid.cell)));
+		int cy = min(grid.nb_y-1,max(0,int(((p1.y+p2.y+p3.y)/3-grid.min_y)/grid.cell)));
+		grid.cells[size_t(cy)*grid.nb_x+cx].push_back(i);
+	}
+}
+
+void select_triangles(triangle_grid &grid, tin &t, double min_x, double max_x, double min_y, double max_y, vector<size_t> &selection){
+	/**
+	* \brief Sélectionne les triangles conservés qui peuvent toucher une fenêtre, triés dans l'ordre de la triangulation
+	* pour que la coloration soit identique à celle d'un rendu complet.
+	* \param grid Index spatial des triangles.
+	* \param t Triangulation indexée.
+	* \param min_x,max_x,min_y,max_y limites de la fenêtre en m.
+	* \param selection Vecteur dans lequel stocker les indices des triangles.
+	*/
+	double margin = t.lim_triangle_lg;
+	int cx0 = max(0,int((min_x-margin-grid.min_x)/grid.cell));
+	int cx1 = min(grid.nb_x-1,int((max_x+margin-grid.min_x)/grid.cell));
+	int cy0 = max(0,int((min_y-margin-grid.min_y)/grid.cell));
+	int cy1 = min(grid.nb_y-1,int((max_y+margin-grid.min_y)/grid.cell));
+
+	selection.clear();
+	for(int cy = cy0; cy <= cy1; cy++){
+		for(int cx = cx0; cx <= cx1; cx++){
+			vector<size_t> &cell = grid.cells[size_t(cy)*grid.nb_x+cx];
+			selection.insert(selection.end(),cell.begin(),cell.end());
+		}
+	}
+	sort(selection.begin(),selection.end());
 }
 
+bool triangle_too_long(const cloud_vector &coords, const index_vector &triangles, size_t i, double lim_triangle_lg){
+	/**
+	* \brief Indique si un des cotés du triangle est plus long que la limite, ce qui permet d'ignorer les triangles
+	* qui relient les bords d'une forme non convexe.
+	* \param coords Coordonnées des points en m sous forme {x0,y0,x1,y1...}.
+	* \param triangles Indices des sommets des triangles (delaunator).
+	* \param i Indice du premier sommet du triangle dans triangles.
+	* \param lim_triangle_lg Longueur maximale d'un coté de triangle.
+	* \return booléen.
+	*/
+	double x0 = coords[2 * triangles[i]];
+	double y0 = coords[2 * triangles[i] + 1];
+	double x1 = coords[2 * triangles[i + 1]];
+	double y1 = coords[2 * triangles[i + 1] + 1];
+	double x2 = coords[2 * triangles[i + 2]];
+	double y2 = coords[2 * triangles[i + 2] + 1];
+
+	//calcul de la taille des segments
+	double norm1 = sqrt(pow(x1-x0,2)+pow(y1-y0,2));
+	double norm2 = sqrt(pow(x2-x1,2)+pow(y2-y1,2));
+	double norm3 = sqrt(pow(x0-x2,2)+pow(y0-y2,2));
+
+	return (norm1 > lim_triangle_lg) || (norm2 > lim_triangle_lg) || (norm3 > lim_triangle_lg);
+}
 
-void find_pixels(Triangle &T,vector<int> &pixels,vector<double> &pixels_illumination){
+void find_pixels(Triangle &T,vector<int> &pixels,vector<double> &pixels_illumination,normal_buffer *pixels_normals,pixel_channels *channels){
 	/**
 	* \brief Trouve l'indice des pixels qui appartiennent au triangle T et les colors.
 	* \param T Triangle à considérer.
 	* \param pixels Liste des pixels.
 	* \param pixels_illumination Vecteur des illuminations des pixels.
+	* \param pixels_normals Normales interpolées des pixels (ombrage lisse), ignorées si nullptr.
+	* \param channels Canaux des pixels en float (profondeur, pente..., voir pixel_channels), ignorés si nullptr.
+	* Le parcours des pixels (fill_pixels) est choisi parmi les versions compilées pour chaque combinaison de canaux.
+	*/
+	int mask = 0;
+	if (channels != nullptr){
+		mask = (channels->depth != nullptr ? channel_depth : 0) | (channels->slope != nullptr ? channel_slope : 0) |
+			(channels->aspect != nullptr ? channel_aspect : 0) | (channels->rugosity != nullptr ? channel_rugosity : 0) |
+			(channels->triangle != nullptr ? channel_triangle : 0);
+	}
+	dispatch_pixels<0>(mask,T,pixels,pixels_illumination,pixels_normals,channels);
+}
+
+template <int channels>
+static void dispatch_pixels(int mask, Triangle &T, vector<int> &pixels, vector<double> &pixels_illumination, normal_buffer *pixels_normals, pixel_channels *out){
+	/**
+	* \brief Appelle la version de fill_pixels compilée pour la combinaison de canaux mask.
+	*/
+	if constexpr (channels < nb_channel_sets){
+		if (mask == channels){
+			fill_pixels<channels>(T,pixels,pixels_illumination,pixels_normals,out);
+		}
+		else{
+			dispatch_pixels<channels+1>(mask,T,pixels,pixels_illumination,pixels_normals,out);
+		}
+	}
+}
+
+template <int channels>
+static void fill_pixels(Triangle &T, vector<int> &pixels, vector<double> &pixels_illumination, normal_buffer *pixels_normals, pixel_channels *out){
+	/**
+	* \brief Colore les pixels qui appartiennent au triangle T (voir find_pixels) et écrit les canaux de channels dans out.
+	* Les canaux absents de channels ne sont pas compilés dans cette version.
 	* Cette fonction à aussi besoin des variables globales suivantes :
 	* - nombre de pixels de l'image (width,height)
 	* - couleur par défaut d'un pixel (default_color)
@@ -221,10 +642,16 @@ void find_pixels(Triangle &T,vector<int> &pixels,vector<double> &pixels_illumina
 
 	//ETAPE 1: Calculer le plus petit rectangle de pixels contenant les 3 sommets pour réduire le temps de recherche
 
+	//triangle en dehors de l'image (rendu d'une fenêtre du relevé)
+	if (max({T.p1.x,T.p2.x,T.p3.x}) < min_x || min({T.p1.x,T.p2.x,T.p3.x}) > max_x ||
+		max({T.p1.y,T.p2.y,T.p3.y}) < min_y || min({T.p1.y,T.p2.y,T.p3.y}) > max_y){
+		return;
+	}
+
 	//calcul des pixels des 3 sommets
-	int pix_p1 = pixel_of_point(*(T.p1));
-	int pix_p2 = pixel_of_point(*(T.p2));
-	int pix_p3 = pixel_of_point(*(T.p3));
+	int pix_p1 = pixel_of_point(T.p1);
+	int pix_p2 = pixel_of_point(T.p2);
+	int pix_p3 = pixel_of_point(T.p3);
 	//cout<< "Pixels : " << "["<<pix_p1<<","<<pix_p2<<","<<pix_p3<<"]"<<endl;
 	
 	//calcul des coordonnées de ces pixels
@@ -232,9 +659,9 @@ void find_pixels(Triangle &T,vector<int> &pixels,vector<double> &pixels_illumina
 	compute_coords_y(pix_p1,coy_1,width);
 	compute_coords_y(pix_p2,coy_2,width);
 	compute_coords_y(pix_p3,coy_3,width);
-	int cox_1 = min(width-((coy_1*width)-pix_p1),height); //pixel numéro ... sur l'axe des abscisses
-	int cox_2 = min(width-((coy_2*width)-pix_p2),height);
-	int cox_3 = min(width-((coy_3*width)-pix_p3),height);
+	int cox_1 = min(width-((coy_1*width)-pix_p1),width); //pixel numéro ... sur l'axe des abscisses
+	int cox_2 = min(width-((coy_2*width)-pix_p2),width);
+	int cox_3 = min(width-((coy_3*width)-pix_p3),width);
 	//cout << "["<<cox_1 << " , " << coy_1 << "]"<< "["<<cox_2 << " , " << coy_2 << "]"<< "["<<cox_3 << " , " << coy_3 << "]" <<endl;
 
 	//calcul des limite du carrée de pixels
@@ -244,6 +671,15 @@ void find_pixels(Triangle &T,vector<int> &pixels,vector<double> &pixels_illumina
 	int max_coy_pix = max({coy_1,coy_2,coy_3});
 	//cout <<"["<< min_cox_pix << " , " << max_cox_pix << " , " << min_coy_pix << " , " << max_coy_pix <<"]"<<endl;
 
+	//pente, orientation et rugosité du plan du triangle, identiques pour tous ses pixels
+	float slope = 0, aspect = 0, rugosity = 0;
+	if constexpr ((channels & (channel_slope|channel_aspect|channel_rugosity)) != 0){
+		T.compute_surface(slope,aspect,rugosity);
+		if (aspect < 0){ //triangle plat
+			aspect = dem_nodata;
+		}
+	}
+
 	////////////
 	////ETAPE2//
 	////////////
@@ -270,6 +706,29 @@ void find_pixels(Triangle &T,vector<int> &pixels,vector<double> &pixels_illumina
 				double depth_estime = T.compute_depth(center_x,center_y);
 				//convertion de la profondeur en indice de couleur
 				pixels[pix_index-1] = convert_to_color(depth_estime);
+				if constexpr ((channels & channel_depth) != 0){
+					out->depth[pix_index-1] = depth_estime;
+				}
+				if constexpr ((channels & channel_slope) != 0){
+					out->slope[pix_index-1] = slope;
+				}
+				if constexpr ((channels & channel_aspect) != 0){
+					out->aspect[pix_index-1] = aspect;
+				}
+				if constexpr ((channels & channel_rugosity) != 0){
+					out->rugosity[pix_index-1] = rugosity;
+				}
+				if constexpr ((channels & channel_triangle) != 0){
+					out->triangle[pix_index-1] = T.index;
+				}
+				//Interpolation de la normale du pixel pour l'ombrage lisse
+				if (pixels_normals != nullptr){
+					float n[3];
+					T.interpolate_normal(center_x,center_y,n);
+					pixels_normals->x[pix_index-1] = n[0];
+					pixels_normals->y[pix_index-1] = n[1];
+					pixels_normals->z[pix_index-1] = n[2];
+				}
 				//cout << "Colored pixel : "<<pix_index<<" (" <<center_x<<","<<center_y<<") = " << pixels[pix_index-1] <<endl;
 			}
 		}
@@ -291,24 +750,39 @@ int convert_to_color(double value){
 	return color;
 }
 
+double convert_to_depth(int color){
+	/**
+	* \brief Cette fonction converti un indice de couleur en profondeur (inverse de convert_to_color).
+	* \param color indice de couleur à convertir.
+	* Cette fonction à aussi besoin des variables globales suivantes :
+	* - nombre de couleurs voulues pour échantilloner la colormap (np_color)
+	* - limites de profondeurs (min_depth, max_depth)
+	*/
+
+	double elongation = max_depth-min_depth;
+
+	return min_depth+color*elongation/nb_colors;
+}
+
 void compute_coords_y(int pixel_index,int &result,int width){
 	/**
 	* \brief Cette fonction calcul les coordonées d'un pixel sur y (en pixel).
 	* \param pixel_index Indice du pixel concerné.
 	* \param result Variable dans laquelle stocker le résultat.
 	* \param width Nombre de pixels sur l'image en largeur.
+	* Cette fonction à aussi besoin de la variable globale height (nombre de pixels sur l'image en hauteur).
 	*/
 
 	if (pixel_index%width == 0){ //gestion des valeur limites qui peuvent poer problème pour les indices
-		result = min((pixel_index/width),width);
+		result = min((pixel_index/width),int(height));
 	}
 	else{
-		result = min((pixel_index/width)+1,width);
+		result = min((pixel_index/width)+1,int(height));
 	}
 }
 
 
-int pixel_of_point(point &point){
+int pixel_of_point(const point &point){
 	/**
 	* \brief Cette fonction renvoie l'indice du pixel qui contient le point donné en paramètre.
 	* \param point	Point pour lequel on veut le pixel correspondant.
@@ -324,15 +798,15 @@ int pixel_of_point(point &point){
 	
 	//calcul du nombre de pixels à l'origine en abscisse du point :
 	double elongation_x = abs(max_x-min_x); //elongation des mesures sur x
-	double percent_x = abs(point.x-min_x)/elongation_x; //placement de x sur cette élongation en pourcentage
+	double percent_x = (point.x-min_x)/elongation_x; //placement de x sur cette élongation en pourcentage
 	int nb_pix_x = (percent_x*width)+1; //on applique ce pourcentage sur le nombre de pixels
-	nb_pix_x = min(double(nb_pix_x),width); //sécurité pour valeur limites qui pose probblème
+	nb_pix_x = max(1.0,min(double(nb_pix_x),width)); //sécurité pour valeur limites qui pose probblème (et points hors de l'image)
 
 	//calcul du nombre de pixels à l'origine en ordonnée du point :
 	double elongation_y = abs(max_y-min_y);
-	double percent_y = 1-(abs(point.y-min_y)/elongation_y); //inversion pourcentage car min_y est à l'opposé du pixel d'indice 0 
+	double percent_y = 1-((point.y-min_y)/elongation_y); //inversion pourcentage car min_y est à l'opposé du pixel d'indice 0 
 	int nb_pix_y = (percent_y*height)+1; 
-	nb_pix_y = min(double(nb_pix_y),height);
+	nb_pix_y = max(1.0,min(double(nb_pix_y),height));
 
 	//calcul de l'indice du pixel sur lequel il est :
 	index = (nb_pix_y*width)-(width-nb_pix_x);
@@ -5,6 +5,8 @@
 #include "struct_point.h"
 #include "Triangle.h"
 #include "struct_point.h"
+#include "shading.h"
+#include "dem.h"
 
 /**
 * \file triangulation.h
@@ -16,10 +18,58 @@
 #ifndef TRIANGULATION_H
 #define TRIANGULATION_H
 
-void triangulate_n_color(std::vector<point> &points, std::vector<double> &points_line,std::vector<int> &pixels, std::vector<double> &pixels_illumination,std::map<std::string,double> &context);
-void find_pixels(Triangle &T,std::vector<int> &pixels, std::vector<double> &pixels_illumination);
-int pixel_of_point(point &point);
+struct tin
+{
+	/**
+	* \brief Triangulation du nuage de points, conservée entre plusieurs rendus.
+	* \param triangles indices des sommets des triangles sous forme {a0,b0,c0,a1,b1,c1...} (delaunator).
+	* \param halfedges demi-arêtes opposées de chaque demi-arête (delaunator).
+	* \param kept booléens indiquant pour chaque triangle s'il est conservé (aucun coté plus long que lim_triangle_lg
+	* et un cercle circonscrit de rayon au plus max_radius).
+	* \param lim_triangle_lg longueur maximale d'un coté de triangle.
+	* \param max_radius rayon maximal du cercle circonscrit d'un triangle conservé, 0 sans limite (voir statistics_radius).
+	* \param vertex_normals normales aux sommets {nx0,ny0,nz0,...}, calculées au premier rendu avec ombrage lisse.
+	*/
+	index_vector triangles;
+	index_vector halfedges;
+	std::vector<char> kept;
+	double lim_triangle_lg = 0;
+	double max_radius = 0;
+	std::vector<float> vertex_normals;
+};
+
+struct triangle_grid
+{
+	/**
+	* \brief Index spatial des triangles conservés : grille régulière dont chaque case contient les triangles dont le centre y est.
+	* Comme les cotés des triangles conservés sont plus petits que lim_triangle_lg, un triangle est entièrement
+	* à moins de lim_triangle_lg de la case qui le contient.
+	* \param min_x,min_y coin inférieur gauche de la grille en m.
+	* \param cell taille d'une case en m.
+	* \param nb_x,nb_y nombre de cases sur x et y.
+	* \param cells indices des triangles de chaque case {case0,case1,...}.
+	*/
+	double min_x = 0, min_y = 0;
+	double cell = 1;
+	int nb_x = 0, nb_y = 0;
+	std::vector<std::vector<std::size_t>> cells;
+};
+
+void set_raster_parameters(std::map<std::string,double> &context);
+void triangulate_n_color(point_cloud &points, std::vector<int> &pixels, std::vector<double> &pixels_illumination,std::map<std::string,double> &context, const std::string &mesh_file = "", pixel_channels *channels = nullptr, const std::string &contour_file = "", const std::string &band_image = "", const std::string &preview_image = "");
+void triangulate(point_cloud &points, tin &t, std::map<std::string,double> &context, double lim_triangle_lg = 0, double max_radius = 0);
+double statistics_radius(std::map<std::string,double> &context, std::size_t nb_points);
+double triangle_circumradius(point *vertices);
+double triangle_length_limit(double sum, double sum_sq, double max_norm, std::size_t nb, double thinning_cell);
+void keep_triangles(point_cloud &points, tin &t, double lim_triangle_lg, int nb_threads, double max_radius = 0);
+void color_triangles(point_cloud &points, tin &t, std::vector<int> &pixels, std::vector<double> &pixels_illumination, std::map<std::string,double> &context, const std::vector<std::size_t> *selection = nullptr, normal_buffer *pixels_normals = nullptr, pixel_channels *channels = nullptr);
+void build_triangle_grid(point_cloud &points, tin &t, std::map<std::string,double> &context, triangle_grid &grid);
+void select_triangles(triangle_grid &grid, tin &t, double min_x, double max_x, double min_y, double max_y, std::vector<std::size_t> &selection);
+bool triangle_too_long(const cloud_vector &coords, const index_vector &triangles, std::size_t i, double lim_triangle_lg);
+void find_pixels(Triangle &T,std::vector<int> &pixels, std::vector<double> &pixels_illumination, normal_buffer *pixels_normals = nullptr, pixel_channels *channels = nullptr);
+int pixel_of_point(const point &point);
 void compute_coords_y(int pixel_index,int &result,int width);
 int convert_to_color(double value);
+double convert_to_depth(int color);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include <cstdlib> // bibliothèque générique standard
+#include <cstring>
+#include <iostream> // bibliothèque d’entrées/sorties
+#include <string>
+#include <vector> //vecteur
+#include <map> //dictionnaires
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "struct_point.h"
+#include "parallel.h"
+#include "triangulation.h"
+#include "init_points_pixels.h"
+#include "generate_image.h"
+#include "thinning.h"
+#include "watch.h"
+
+/**
+* \file watch.cpp
+* \brief Fichier d'implémentation du mode suivi, pour un relevé en cours d'acquisition dont le fichier ne fait que grandir.
+* Après un premier rendu complet, les lignes ajoutées au fichier sont lues à intervalle régulier. Les nouveaux points
+* sont triangulés avec les anciens, et seuls les triangles conservés qui diffèrent de la triangulation précédente
+* marquent les tuiles de l'image (watch_tile_size pixels de coté) qu'ils touchent : ces tuiles sont recalculées
+* et réécrites en place dans l'image. La longueur maximale d'un coté de triangle du premier rendu est gardée pour que
+* la sélection des autres triangles ne change pas. Un rendu complet est refait si l'emprise ou l'intervalle
+* de profondeurs du relevé grandit (les pixels ou les couleurs de toute l'image changent), avec la réduction des points
+* (les cases dépendent de tous les points) et avec les ombres portées (elles traversent les tuiles).
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+using namespace std;
+
+static int read_appended_points(const string &file_name, size_t &offset, point_cloud &points);
+static void full_render(point_cloud &points, tin &t, triangle_grid &grid, map<string,double> &context);
+static void vertex_halfedges(const tin &t, size_t nb_points, vector<tin_index> &incoming);
+static bool has_triangle(const tin &t, const vector<tin_index> &incoming, const tin_index *vertices);
+static void mark_triangle(point_cloud &points, const tin &t, size_t i, map<string,double> &context, double margin, vector<char> &dirty);
+static bool write_tile(point_cloud &points, tin &t, triangle_grid &grid, map<string,double> &context, int tile_x, int tile_y, int fd);
+
+static const int watch_tile_size = 64; //taille en pixels des tuiles de l'image recalculées
+
+int run_watch(string file_name, map<string,double> &context){
+	/**
+	* \brief Rend le relevé dans raster.ppm puis suit le fichier, voir watch.cpp.
+	* \param file_name nom du fichier du relevé (texte non compressé).
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise l'intervalle entre deux lectures du fichier en s (watch), la durée en s sans nouvelles
+	* données après laquelle le suivi s'arrête (watch_timeout, 0 = jamais) et les paramètres du rendu (voir color_triangles).
+	* \return 1 si le suivi s'est terminé normalement, 0 sinon.
+	*/
+	cout << endl << "Watch mode (" << file_name << " read every " << context["watch"] << " s) :" << endl;
+	size_t offset = 0;
+	point_cloud points; //tous les points lus
+	if (read_appended_points(file_name,offset,points) == 0){
+		return 0;
+	}
+	project_points(&points,context); //(Voir init_point_pixels.cpp)
+	tin t;
+	triangle_grid grid;
+	full_render(points,t,grid,context);
+
+	double idle = 0; //durée sans nouvelles données
+	while(context["watch_timeout"] == 0 || idle < context["watch_timeout"]){
+		this_thread::sleep_for(chrono::duration<double>(context["watch"]));
+		point_cloud appended;
+		int result = read_appended_points(file_name,offset,appended);
+		if (result == 0){
+			return 0;
+		}
+		if (appended.size() == 0){
+			idle += context["watch"];
+			continue;
+		}
+		idle = 0;
+		auto t0 = chrono::steady_clock::now();
+
+		//projection des nouveaux points, l'emprise et les profondeurs du relevé sont mises à jour dans une copie de context
+		map<string,double> appended_context = context;
+		project_points(&appended,appended_context);
+		bool grown = false;
+		for(string limit : {"min_x","max_x","min_y","max_y","min_depth","max_depth"}){
+			grown = grown || appended_context[limit] != context[limit];
+		}
+		for(size_t i = 0; i < appended.size(); i++){
+			points.push_back(appended[i]);
+		}
+		if (grown || context["thinning"] != 0 || context["shadows"] == 1){
+			context = appended_context;
+			full_render(points,t,grid,context);
+			continue;
+		}
+
+		//nouvelle triangulation avec la longueur maximale (et le rayon maximal) du rendu précédent
+		tin previous = move(t);
+		t = tin();
+		triangulate(points,t,context,previous.lim_triangle_lg,previous.max_radius); //(Voir triangulation.cpp)
+
+		//tuiles touchées par les triangles conservés qui ne sont que dans l'une des deux triangulations,
+		//avec une marge pour les normales aux sommets de l'ombrage lisse (triangles voisins à moins de lim_triangle_lg)
+		int nb_tiles_x = (int(context["width"])+watch_tile_size-1)/watch_tile_size;
+		int nb_tiles_y = (int(context["height"])+watch_tile_size-1)/watch_tile_size;
+		vector<char> dirty(size_t(nb_tiles_x)*nb_tiles_y,0);
+		double margin = (context["shading"] == 1) ? t.lim_triangle_lg : 0;
+		//un triangle conservé d'une triangulation est modifié s'il n'est pas dans l'autre (mêmes sommets, donc aussi conservé) :
+		//les triangles avec un nouveau point le sont, les autres sont cherchés autour de leur premier sommet
+		vector<tin_index> previous_incoming, incoming;
+		vertex_halfedges(previous,points.size(),previous_incoming);
+		vertex_halfedges(t,points.size(),incoming);
+		size_t nb_previous_points = points.size()-appended.size();
+		int nb_threads = max(1,int(context["nb_threads"]));
+		vector<vector<char>> thread_dirty(nb_threads,dirty);
+		parallel_for(t.kept.size(),nb_threads,[&](size_t begin, size_t end, int thread){
+			for(size_t i = begin; i < end; i++){
+				const tin_index *vertices = &t.triangles[3*i];
+				if (t.kept[i] && (max({vertices[0],vertices[1],vertices[2]}) >= nb_previous_points || !has_triangle(previous,previous_incoming,vertices))){
+					mark_triangle(points,t,i,context,margin,thread_dirty[thread]);
+				}
+			}
+		});
+		parallel_for(previous.kept.size(),nb_threads,[&](size_t begin, size_t end, int thread){
+			for(size_t i = begin; i < end; i++){
+				if (previous.kept[i] && !has_triangle(t,incoming,&previous.triangles[3*i])){
+					mark_triangle(points,previous,i,context,margin,thread_dirty[thread]);
+				}
+			}
+		});
+		for(vector<char> &d : thread_dirty){
+			for(size_t k = 0; k < dirty.size(); k++){
+				dirty[k] |= d[k];
+			}
+		}
+		previous = tin();
+
+		//rendu et écriture des tuiles touchées
+		build_triangle_grid(points,t,context,grid);
+		int fd = open("raster.ppm",O_WRONLY);
+		if (fd < 0){
+			cout << "echec d'ouverture du fichier image" << endl;
+			return 0;
+		}
+		size_t nb_dirty = 0;
+		for(int ty = 0; ty < nb_tiles_y; ty++){
+			for(int tx = 0; tx < nb_tiles_x; tx++){
+				if (dirty[size_t(ty)*nb_tiles_x+tx] && write_tile(points,t,grid,context,tx,ty,fd)){
+					nb_dirty++;
+				}
+			}
+		}
+		close(fd);
+		double seconds = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+		cout << "- Refresh : " << appended.size() << " new points, " << nb_dirty << "/" << dirty.size() << " tiles rewritten in " << seconds << " s" << endl;
+	}
+	return 1;
+}
+
+static int read_appended_points(const string &file_name, size_t &offset, point_cloud &points){
+	/**
+	* \brief Lit les lignes complètes ajoutées au fichier depuis offset (une ligne en cours d'écriture est lue la fois suivante).
+	* \param file_name nom du fichier du relevé.
+	* \param offset position de la première ligne non lue, avancée après la dernière ligne lue.
+	* \param points nuage dans lequel ajouter les points lus (non projetés).
+	* \return 1 si la lecture a réussi, 0 si le fichier ne peut pas être suivi.
+	*/
+	int fd = open(file_name.c_str(),O_RDONLY);
+	if (fd < 0){
+		cout << "Echec d'ouverture de " << file_name << endl;
+		return 0;
+	}
+	struct stat file_stat;
+	size_t size = (fstat(fd,&file_stat) == 0) ? file_stat.st_size : 0;
+	if (size < offset){
+		cout << "Fichier " << file_name << " raccourci, suivi arrêté" << endl;
+		close(fd);
+		return 0;
+	}
+	vector<char> data(size-offset);
+	size_t nb_read = 0;
+	while(nb_read < data.size()){
+		ssize_t n = pread(fd,data.data()+nb_read,data.size()-nb_read,offset+nb_read);
+		if (n <= 0){
+			break;
+		}
+		nb_read += n;
+	}
+	close(fd);
+	if (offset == 0 && nb_read >= 2 && (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b){
+		cout << "Le mode suivi ne lit pas les fichiers compressés (" << file_name << ")" << endl;
+		return 0;
+	}
+
+	//lignes complètes uniquement
+	size_t end = nb_read;
+	while(end > 0 && data[end-1] != '\n'){
+		end--;
+	}
+	size_t begin = 0;
+	string str;
+	while(begin < end){
+		size_t line_end = find(data.begin()+begin,data.begin()+end,'\n')-data.begin();
+		str.assign(data.data()+begin,line_end-begin);
+		begin = line_end+1;
+		if (str.find_first_not_of(" \t\r") == string::npos){ //ligne vide
+			continue;
+		}
+		point p;
+		try{
+			get_point(p,str); //(Voir init_point_pixels.cpp)
+			points.push_back(p);
+		}
+		catch(...){
+			cout << "Ligne invalide ignorée : " << str << endl;
+		}
+	}
+	offset += end;
+	return 1;
+}
+
+static void full_render(point_cloud &points, tin &t, triangle_grid &grid, map<string,double> &context){
+	/**
+	* \brief Triangule tous les points et rend l'image entière dans raster.ppm.
+	* Avec la réduction des points, c'est une copie réduite des points qui est triangulée et la triangulation
+	* ne sert pas aux lectures suivantes.
+	* \param points Points projetés du relevé.
+	* \param t Triangulation calculée.
+	* \param grid Index spatial des triangles conservés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	*/
+	auto t0 = chrono::steady_clock::now();
+	set_pixel_size(context); //(Voir init_point_pixels.cpp)
+	vector<int> pixels;
+	vector<double> pixels_illumination;
+	create_pixels(pixels,pixels_illumination,context);
+	t = tin();
+	if (context["thinning"] != 0){
+		point_cloud thinned = points;
+		thin_points(thinned,context); //(Voir thinning.cpp)
+		triangulate(thinned,t,context); //(Voir triangulation.cpp)
+		color_triangles(thinned,t,pixels,pixels_illumination,context);
+		t = tin();
+	}
+	else{
+		triangulate(points,t,context);
+		color_triangles(points,t,pixels,pixels_illumination,context);
+		build_triangle_grid(points,t,context,grid);
+	}
+	if (generate_image(pixels,pixels_illumination,context) == 0){ //(Voir generate_image.cpp)
+		cout << "echec d'ouverture du fichier image" << endl;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+	cout << "- Full render of " << points.size() << " points in " << seconds << " s" << endl;
+}
+
+static void vertex_halfedges(const tin &t, size_t nb_points, vector<tin_index> &incoming){
+	/**
+	* \brief Choisit pour chaque point une demi-arête qui y arrive, la première en tournant autour du point
+	* (une demi-arête du bord pour un point de l'enveloppe convexe), pour parcourir ses triangles (voir has_triangle).
+	* \param t Triangulation avec ses demi-arêtes.
+	* \param nb_points Nombre de points.
+	* \param incoming Vecteur dans lequel stocker les demi-arêtes (no_halfedge pour un point sans triangle).
+	*/
+	incoming.assign(nb_points,no_halfedge);
+	for(size_t e = 0; e < t.triangles.size(); e++){
+		tin_index end = t.triangles[(e%3 == 2) ? e-2 : e+1];
+		if (incoming[end] == no_halfedge || t.halfedges[e] == no_halfedge){
+			incoming[end] = e;
+		}
+	}
+}
+
+static bool has_triangle(const tin &t, const vector<tin_index> &incoming, const tin_index *vertices){
+	/**
+	* \brief Cherche un triangle dans une triangulation parmi les triangles autour de son premier sommet.
+	* \param t Triangulation avec ses demi-arêtes.
+	* \param incoming Demi-arêtes qui arrivent à chaque point (voir vertex_halfedges).
+	* \param vertices Sommets du triangle cherché.
+	* \return true si un triangle de t a ces trois sommets.
+	*/
+	tin_index start = (vertices[0] < incoming.size()) ? incoming[vertices[0]] : no_halfedge;
+	tin_index e = start;
+	while(e != no_halfedge){
+		size_t first = e-e%3;
+		bool found = true;
+		for(int k = 0; k < 3 && found; k++){
+			found = find(vertices,vertices+3,t.triangles[first+k]) != vertices+3;
+		}
+		if (found){
+			return true;
+		}
+		tin_index outgoing = (e%3 == 2) ? e-2 : e+1;
+		e = t.halfedges[outgoing];
+		if (e == start){
+			break;
+		}
+	}
+	return false;
+}
+
+static void mark_triangle(point_cloud &points, const tin &t, size_t i, map<string,double> &context, double margin, vector<char> &dirty){
+	/**
+	* \brief Marque les tuiles de l'image qui touchent le rectangle englobant d'un triangle agrandi d'une marge.
+	* \param points Points de la triangulation.
+	* \param t Triangulation.
+	* \param i Indice du triangle.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* Ici cette fonction utilise la taille et les limites de l'image.
+	* \param margin Marge en m.
+	* \param dirty Tuiles à recalculer, ligne par ligne.
+	*/
+	double x0 = min({points.x(t.triangles[3*i]),points.x(t.triangles[3*i+1]),points.x(t.triangles[3*i+2])})-margin;
+	double x1 = max({points.x(t.triangles[3*i]),points.x(t.triangles[3*i+1]),points.x(t.triangles[3*i+2])})+margin;
+	double y0 = min({points.y(t.triangles[3*i]),points.y(t.triangles[3*i+1]),points.y(t.triangles[3*i+2])})-margin;
+	double y1 = max({points.y(t.triangles[3*i]),points.y(t.triangles[3*i+1]),points.y(t.triangles[3*i+2])})+margin;
+	int nb_tiles_x = (int(context["width"])+watch_tile_size-1)/watch_tile_size;
+	int nb_tiles_y = (int(context["height"])+watch_tile_size-1)/watch_tile_size;
+	auto tile_x = [&](double x){ return min(nb_tiles_x-1,max(0,int(floor((x-context["min_x"])/context["lg_pix"]))/watch_tile_size)); };
+	auto tile_y = [&](double y){ return min(nb_tiles_y-1,max(0,int(floor((context["max_y"]-y)/context["h_pix"]))/watch_tile_size)); };
+	for(int ty = tile_y(y1); ty <= tile_y(y0); ty++){
+		for(int tx = tile_x(x0); tx <= tile_x(x1); tx++){
+			dirty[size_t(ty)*nb_tiles_x+tx] = 1;
+		}
+	}
+}
+
+static bool write_tile(point_cloud &points, tin &t, triangle_grid &grid, map<string,double> &context, int tile_x, int tile_y, int fd){
+	/**
+	* \brief Rend une tuile de l'image avec les pixels de l'image entière et écrit ses lignes à leur place dans l'image.
+	* \param points Points de la triangulation.
+	* \param t Triangulation.
+	* \param grid Index spatial des triangles conservés.
+	* \param context Dictionnaire qui contient les données importantes (evite les variables globales).
+	* \param tile_x,tile_y position de la tuile.
+	* \param fd fichier de l'image.
+	* \return true si la tuile a été écrite.
+	*/
+	int width = context["width"];
+	int height = context["height"];
+	int c0 = tile_x*watch_tile_size;
+	int c1 = min(width,c0+watch_tile_size);
+	int r0 = tile_y*watch_tile_size;
+	int r1 = min(height,r0+watch_tile_size);
+
+	//fenêtre de la tuile, alignée sur les pixels de l'image
+	map<string,double> tile_context = context;
+	tile_context["min_x"] = (c0 == 0) ? context["min_x"] : context["min_x"]+c0*context["lg_pix"];
+	tile_context["max_x"] = (c1 == width) ? context["max_x"] : context["min_x"]+c1*context["lg_pix"];
+	tile_context["max_y"] = (r0 == 0) ? context["max_y"] : context["max_y"]-r0*context["h_pix"];
+	tile_context["min_y"] = (r1 == height) ? context["min_y"] : context["max_y"]-r1*context["h_pix"];
+	tile_context["width"] = c1-c0;
+	tile_context["height"] = r1-r0;
+	vector<size_t> selection;
+	select_triangles(grid,t,tile_context["min_x"],tile_context["max_x"],tile_context["min_y"],tile_context["max_y"],selection);
+	vector<int> pixels;
+	vector<double> pixels_illumination;
+	create_pixels(pixels,pixels_illumination,tile_context); //(Voir init_point_pixels.cpp)
+	tile_context["lg_pix"] = context["lg_pix"];
+	tile_context["h_pix"] = context["h_pix"];
+	color_triangles(points,t,pixels,pixels_illumination,tile_context,&selection); //(Voir triangulation.cpp)
+	vector<char> image;
+	colorize_pixels(pixels,pixels_illumination,tile_context,image); //(Voir generate_image.cpp)
+
+	size_t header_size = image_header(width,height).size();
+	size_t row_size = 3*size_t(c1-c0);
+	for(int r = r0; r < r1; r++){
+		off_t position = header_size+3*(size_t(r)*width+c0);
+		if (pwrite(fd,image.data()+(r-r0)*row_size,row_size,position) != ssize_t(row_size)){
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,18 @@
+#include <cstdlib>
+#include <string>
+#include <map> //dictionnaires
+
+#ifndef WATCH_H
+#define WATCH_H
+
+/**
+* \file watch.h
+* \brief Fichier de déclaration du mode suivi : le fichier du relevé est relu au fur et à mesure qu'il grandit
+* et seules les tuiles de l'image touchées par les triangles modifiés sont recalculées et réécrites.
+* \date 19/10/2026
+* \author NOEL Océan
+*/
+
+int run_watch(std::string file_name, std::map<std::string,double> &context);
+
+#endif
@@ -0,0 +1,24 @@
+# Rendu par tuiles comparé au rendu en un seul processus : les deux images doivent être identiques.
+# cmake -DEXECUTABLE=programme -DSURVEY=relevé -DWORK_DIR=dossier -P tiles_match.cmake
+# Le relevé est copié dans WORK_DIR/assets et les rendus sont faits dans WORK_DIR/build (relevés cherchés dans ../assets).
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/assets ${WORK_DIR}/build)
+get_filename_component(survey_name ${SURVEY} NAME)
+configure_file(${SURVEY} ${WORK_DIR}/assets/${survey_name} COPYONLY)
+
+execute_process(COMMAND ${EXECUTABLE} ${survey_name} 300 WORKING_DIRECTORY ${WORK_DIR}/build RESULT_VARIABLE result OUTPUT_QUIET)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "echec du rendu en un seul processus (${result})")
+endif()
+file(RENAME ${WORK_DIR}/build/raster.ppm ${WORK_DIR}/build/single.ppm)
+
+execute_process(COMMAND ${EXECUTABLE} ${survey_name} 300 --tiles 3 WORKING_DIRECTORY ${WORK_DIR}/build RESULT_VARIABLE result OUTPUT_QUIET)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "echec du rendu par tuiles (${result})")
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${WORK_DIR}/build/single.ppm ${WORK_DIR}/build/raster.ppm RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "le rendu par tuiles differe du rendu en un seul processus")
+endif()